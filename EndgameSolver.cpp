@@ -0,0 +1,238 @@
+/**
+ * @brief Exact shot selection for the last few unknown cells of a round.
+ * @file EndgameSolver.cpp
+ */
+
+#include <limits>
+#include <algorithm>
+#include <functional>
+
+#include "EndgameSolver.h"
+
+using namespace std;
+
+// Default limits; past either one the search gives up and the player falls back to its heuristic.
+static const int DEFAULT_MAX_LAYOUTS = 20000;
+static const size_t DEFAULT_MAX_TABLE_ENTRIES = 20000;
+static const int DEFAULT_MAX_LIVE_CELLS = 10;
+static const long NODES_PER_CLOCK_CHECK = 256;
+
+static int lowestBit(uint64_t bits) {
+    return __builtin_ctzll(bits);
+}
+
+EndgameSolver::EndgameSolver()
+    : maxLayouts(DEFAULT_MAX_LAYOUTS), maxLiveCells(DEFAULT_MAX_LIVE_CELLS),
+      maxTableEntries(DEFAULT_MAX_TABLE_ENTRIES),
+      layoutCount(0), nodes(0), aborted(false)
+{
+}
+
+void EndgameSolver::setLimits(int maxLayouts, int maxLiveCells, size_t maxTableEntries) {
+    this->maxLayouts = maxLayouts;
+    this->maxLiveCells = maxLiveCells;
+    this->maxTableEntries = maxTableEntries;
+}
+
+bool EndgameSolver::solve(int rows, int cols, const Bitboard& unknown, const Bitboard& open,
+			  const vector<int>& shipLengths, Clock::time_point deadline,
+			  int& row, int& col) {
+    if( shipLengths.empty() ) {
+	return false;
+    }
+
+    this->unknown = unknown;
+    this->open = open;
+
+    // Longest ships first prunes the enumeration soonest
+    lengths = shipLengths;
+    sort(lengths.begin(), lengths.end(), greater<int>());
+    placements.assign(lengths.size(), vector<Bitboard>());
+    for( size_t ship=0; ship<lengths.size(); ship++ ) {
+	if( ship > 0 && lengths[ship] == lengths[ship-1] ) {
+	    placements[ship] = placements[ship-1];
+	    continue;
+	}
+	int length = lengths[ship];
+	for( int r=0; r<rows; r++ ) {
+	    for( int c=0; c<cols; c++ ) {
+		Bitboard horizontal, vertical;
+		bool horizontalFits = c + length <= cols;
+		bool verticalFits = r + length <= rows;
+		for( int i=0; i<length; i++ ) {
+		    if( horizontalFits ) {
+			horizontalFits = open.test(Bitboard::cell(r, c+i));
+			horizontal.set(Bitboard::cell(r, c+i));
+		    }
+		    if( verticalFits ) {
+			verticalFits = open.test(Bitboard::cell(r+i, c));
+			vertical.set(Bitboard::cell(r+i, c));
+		    }
+		}
+		if( horizontalFits ) placements[ship].push_back(horizontal);
+		if( verticalFits && length > 1 ) placements[ship].push_back(vertical);
+	    }
+	}
+    }
+
+    layoutWeights.clear();
+    layoutCount = 0;
+    if( !enumerateLayouts(0, 0, Bitboard()) || layoutWeights.empty() ) {
+	return false;
+    }
+    projections.clear();
+    weights.clear();
+    vector<int> consistent;
+    Bitboard live;
+    for( unordered_map<Bitboard, int, BitboardHash>::const_iterator it = layoutWeights.begin();
+	 it != layoutWeights.end(); ++it ) {
+	consistent.push_back(projections.size());
+	projections.push_back(it->first);
+	weights.push_back(it->second);
+	live = live | it->first;
+    }
+
+    // The search is exponential in the number of cells a ship could still be on
+    if( __builtin_popcountll(live.low) + __builtin_popcountll(live.high) > maxLiveCells ) {
+	return false;
+    }
+
+    table.clear();
+    this->deadline = deadline;
+    nodes = 0;
+    aborted = false;
+
+    // Same as expectedShots(), but remembering which first shot was best
+    long total = 0;
+    long cellWeight[2 * 64] = {0};
+    for( size_t i=0; i<consistent.size(); i++ ) {
+	const Bitboard& projection = projections[consistent[i]];
+	total += weights[consistent[i]];
+	for( uint64_t bits = projection.low; bits; bits &= bits - 1 ) cellWeight[lowestBit(bits)] += weights[consistent[i]];
+	for( uint64_t bits = projection.high; bits; bits &= bits - 1 ) cellWeight[64 + lowestBit(bits)] += weights[consistent[i]];
+    }
+
+    double best = numeric_limits<double>::max();
+    int bestCell = -1;
+    for( int cell=0; cell<2*64 && !aborted; cell++ ) {
+	if( cellWeight[cell] == 0 ) continue;
+	Bitboard shot, hit;
+	shot.set(cell);
+	hit.set(cell);
+	vector<int> hitLayouts, missLayouts;
+	for( size_t i=0; i<consistent.size(); i++ ) {
+	    (projections[consistent[i]].test(cell) ? hitLayouts : missLayouts).push_back(consistent[i]);
+	}
+	double hitChance = (double)cellWeight[cell] / (double)total;
+	double expected = 1.0 + hitChance * expectedShots(hitLayouts, shot, hit);
+	if( !missLayouts.empty() ) {
+	    expected += (1.0 - hitChance) * expectedShots(missLayouts, shot, Bitboard());
+	}
+	if( expected < best ) {
+	    best = expected;
+	    bestCell = cell;
+	}
+    }
+
+    if( aborted || bestCell < 0 ) {
+	return false;
+    }
+    row = bestCell / MAX_BOARD_SIZE;
+    col = bestCell % MAX_BOARD_SIZE;
+    return true;
+}
+
+/*
+ * Places lengths[shipIndex..] on top of 'occupied' in every legal way and records
+ * which unknown cells each complete layout covers. A layout only counts if it
+ * covers every unsunk hit. Ships of equal length take placements in increasing
+ * order so each layout is counted once.
+ * Returns false once more than maxLayouts layouts have been tried.
+ */
+bool EndgameSolver::enumerateLayouts(size_t shipIndex, size_t firstPlacement, const Bitboard& occupied) {
+    if( shipIndex == lengths.size() ) {
+	if( open.without(unknown).without(occupied).empty() ) {
+	    layoutWeights[occupied & unknown]++;
+	}
+	return ++layoutCount <= maxLayouts;
+    }
+
+    const vector<Bitboard>& options = placements[shipIndex];
+    bool nextIsSameLength = shipIndex + 1 < lengths.size() && lengths[shipIndex+1] == lengths[shipIndex];
+    for( size_t i=firstPlacement; i<options.size(); i++ ) {
+	if( options[i].intersects(occupied) ) continue;
+	if( !enumerateLayouts(shipIndex + 1, nextIsSameLength ? i + 1 : 0, occupied | options[i]) ) {
+	    return false;
+	}
+    }
+    return true;
+}
+
+/*
+ * Expected number of further shots needed to hit every remaining ship cell,
+ * given the layouts still consistent with the shots taken so far in the search.
+ */
+double EndgameSolver::expectedShots(const vector<int>& consistent, const Bitboard& shot, const Bitboard& hit) {
+    StateKey key = { shot, hit };
+    unordered_map<StateKey, double, StateKeyHash>::const_iterator found = table.find(key);
+    if( found != table.end() ) {
+	return found->second;
+    }
+    if( outOfBudget() ) {
+	return 0;
+    }
+
+    long total = 0;
+    long cellWeight[2 * 64] = {0};
+    for( size_t i=0; i<consistent.size(); i++ ) {
+	Bitboard remaining = projections[consistent[i]].without(shot);
+	total += weights[consistent[i]];
+	for( uint64_t bits = remaining.low; bits; bits &= bits - 1 ) cellWeight[lowestBit(bits)] += weights[consistent[i]];
+	for( uint64_t bits = remaining.high; bits; bits &= bits - 1 ) cellWeight[64 + lowestBit(bits)] += weights[consistent[i]];
+    }
+
+    double best = numeric_limits<double>::max();
+    for( int cell=0; cell<2*64 && !aborted; cell++ ) {
+	if( cellWeight[cell] == 0 ) continue;
+	Bitboard cellBit;
+	cellBit.set(cell);
+
+	// A certain hit gives no information, so when to take it doesn't matter: take it now
+	if( cellWeight[cell] == total ) {
+	    best = 1.0 + expectedShots(consistent, shot | cellBit, hit | cellBit);
+	    break;
+	}
+
+	vector<int> hitLayouts, missLayouts;
+	for( size_t i=0; i<consistent.size(); i++ ) {
+	    (projections[consistent[i]].test(cell) ? hitLayouts : missLayouts).push_back(consistent[i]);
+	}
+	double hitChance = (double)cellWeight[cell] / (double)total;
+	double expected = 1.0 + hitChance * expectedShots(hitLayouts, shot | cellBit, hit | cellBit)
+			      + (1.0 - hitChance) * expectedShots(missLayouts, shot | cellBit, hit);
+	if( expected < best ) {
+	    best = expected;
+	}
+    }
+    if( best == numeric_limits<double>::max() ) {
+	best = 0;	// Every consistent layout is already fully hit
+    }
+
+    if( !aborted ) {
+	table[key] = best;
+    }
+    return best;
+}
+
+/*
+ * Checks the table size every node and the clock every few hundred nodes.
+ */
+bool EndgameSolver::outOfBudget() {
+    if( !aborted && table.size() >= maxTableEntries ) {
+	aborted = true;
+    }
+    if( !aborted && ++nodes % NODES_PER_CLOCK_CHECK == 0 && Clock::now() >= deadline ) {
+	aborted = true;
+    }
+    return aborted;
+}
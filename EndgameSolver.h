@@ -0,0 +1,128 @@
+/**
+ * @brief Exact shot selection for the last few unknown cells of a round.
+ * @file EndgameSolver.h
+ *
+ * Once only a handful of cells are still unknown, every placement of the
+ * remaining ships that is consistent with the board can be enumerated. The
+ * solver then searches the tree of possible shots and outcomes and picks the
+ * shot that minimizes the expected number of shots until every remaining ship
+ * cell has been hit. Subproblems are reached through many shot orders, so their
+ * values are kept in a transposition table keyed by the (shot, hit) bitboards.
+ */
+
+#ifndef ENDGAMESOLVER_H		// Double inclusion protection
+#define ENDGAMESOLVER_H
+
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <stdint.h>
+#include <unordered_map>
+
+#include "defines.h"
+
+/**
+ * @brief One bit per cell of a MAX_BOARD_SIZE x MAX_BOARD_SIZE board.
+ * Cell (row, col) is bit row*MAX_BOARD_SIZE + col.
+ */
+class Bitboard {
+    public:
+	uint64_t low;
+	uint64_t high;
+
+	Bitboard() : low(0), high(0) {}
+
+	static int cell(int row, int col) { return row * MAX_BOARD_SIZE + col; }
+
+	void set(int cell) {
+	    if( cell < 64 ) low |= (uint64_t)1 << cell;
+	    else high |= (uint64_t)1 << (cell - 64);
+	}
+	bool test(int cell) const {
+	    return cell < 64 ? (low >> cell) & 1 : (high >> (cell - 64)) & 1;
+	}
+	bool empty() const { return low == 0 && high == 0; }
+	bool intersects(const Bitboard& other) const {
+	    return (low & other.low) != 0 || (high & other.high) != 0;
+	}
+	Bitboard operator&(const Bitboard& other) const {
+	    Bitboard result; result.low = low & other.low; result.high = high & other.high; return result;
+	}
+	Bitboard operator|(const Bitboard& other) const {
+	    Bitboard result; result.low = low | other.low; result.high = high | other.high; return result;
+	}
+	Bitboard without(const Bitboard& other) const {
+	    Bitboard result; result.low = low & ~other.low; result.high = high & ~other.high; return result;
+	}
+	bool operator==(const Bitboard& other) const {
+	    return low == other.low && high == other.high;
+	}
+};
+
+struct BitboardHash {
+    size_t operator()(const Bitboard& board) const {
+	uint64_t mixed = board.low * 0x9E3779B97F4A7C15ULL ^ (board.high + 0x632BE59BD9B4E019ULL) * 0xC2B2AE3D27D4EB4FULL;
+	return (size_t)(mixed ^ (mixed >> 29));
+    }
+};
+
+class EndgameSolver {
+    public:
+	typedef std::chrono::steady_clock Clock;
+
+	EndgameSolver();
+
+	/**
+	 * @brief Finds the shot that minimizes the expected number of remaining shots.
+	 * @param rows,cols Dimensions of the board in use.
+	 * @param unknown Cells we haven't shot at yet.
+	 * @param open Cells a ship still afloat may be on: unknown cells and unsunk hits.
+	 * @param shipLengths Lengths of the opponent's ships still afloat.
+	 * @param deadline The search gives up when this passes.
+	 * @param row,col Set to the chosen shot on success.
+	 * @return false if there are too many layouts, no consistent layout, or the
+	 * search ran out of time or table space; the caller should use its heuristic.
+	 */
+	bool solve(int rows, int cols, const Bitboard& unknown, const Bitboard& open,
+		   const std::vector<int>& shipLengths, Clock::time_point deadline,
+		   int& row, int& col);
+
+	void setLimits(int maxLayouts, int maxLiveCells, size_t maxTableEntries);
+
+    private:
+	struct StateKey {
+	    Bitboard shot;
+	    Bitboard hit;
+	    bool operator==(const StateKey& other) const { return shot == other.shot && hit == other.hit; }
+	};
+	struct StateKeyHash {
+	    size_t operator()(const StateKey& key) const {
+		BitboardHash hash;
+		return hash(key.shot) * 31 + hash(key.hit);
+	    }
+	};
+
+	bool enumerateLayouts(size_t shipIndex, size_t firstPlacement, const Bitboard& occupied);
+	double expectedShots(const std::vector<int>& consistent, const Bitboard& shot, const Bitboard& hit);
+	bool outOfBudget();
+
+	int maxLayouts;
+	int maxLiveCells;		// Unknown cells that some layout covers
+	size_t maxTableEntries;
+
+	// Per-solve state
+	Bitboard unknown;				// Cells not yet shot at
+	Bitboard open;
+	std::vector<int> lengths;			// Remaining ships, longest first
+	std::vector<std::vector<Bitboard> > placements;	// Legal placements per entry of lengths
+	std::unordered_map<Bitboard, int, BitboardHash> layoutWeights;	// Unknown cells covered -> number of layouts
+	int layoutCount;
+	std::vector<Bitboard> projections;		// Distinct keys of layoutWeights
+	std::vector<int> weights;
+	std::unordered_map<StateKey, double, StateKeyHash> table;
+	Clock::time_point deadline;
+	long nodes;
+	bool aborted;
+};
+
+#endif
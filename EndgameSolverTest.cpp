@@ -0,0 +1,85 @@
+/**
+ * @brief Checks for EndgameSolver on small hand-made positions.
+ * @file EndgameSolverTest.cpp
+ *
+ * Run with 'make check'. Prints one line per failed check and exits non-zero
+ * if any failed.
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "EndgameSolver.h"
+
+using namespace std;
+
+int failures = 0;
+
+/*
+ * Builds the solver's bitboards from rows of text: '~' water, 'X' unsunk hit,
+ * '*' miss, 'K' sunk ship.
+ */
+void parseBoard( const vector<string>& rows, Bitboard& unknown, Bitboard& open ) {
+    for( size_t r=0; r<rows.size(); r++ ) {
+	for( size_t c=0; c<rows[r].size(); c++ ) {
+	    if( rows[r][c] == WATER ) unknown.set(Bitboard::cell(r, c));
+	    if( rows[r][c] == WATER || rows[r][c] == HIT ) open.set(Bitboard::cell(r, c));
+	}
+    }
+}
+
+void check( bool ok, const string& what ) {
+    if( !ok ) {
+	cout << "FAILED: " << what << endl;
+	failures++;
+    }
+}
+
+/*
+ * An unsunk hit at (0,0) with a miss to its right: the only place left for
+ * the length-2 ship is (0,0)-(1,0), so (1,0) is a certain hit.
+ */
+void testHitMustBeCovered() {
+    vector<string> rows;
+    rows.push_back("X*~");
+    rows.push_back("~~~");
+    rows.push_back("~~~");
+    Bitboard unknown, open;
+    parseBoard(rows, unknown, open);
+
+    EndgameSolver solver;
+    int row = -1, col = -1;
+    bool solved = solver.solve(3, 3, unknown, open, vector<int>(1, 2),
+			       EndgameSolver::Clock::now() + std::chrono::seconds(5), row, col);
+    check(solved, "hit must be covered: solve() succeeds");
+    check(row == 1 && col == 0, "hit must be covered: shoots (1,0)");
+}
+
+/*
+ * An unsunk hit boxed in by misses can't belong to a length-2 ship, so there
+ * is no consistent layout and the solver must give up.
+ */
+void testNoConsistentLayout() {
+    vector<string> rows;
+    rows.push_back("X*~");
+    rows.push_back("*~~");
+    rows.push_back("~~~");
+    Bitboard unknown, open;
+    parseBoard(rows, unknown, open);
+
+    EndgameSolver solver;
+    int row = -1, col = -1;
+    bool solved = solver.solve(3, 3, unknown, open, vector<int>(1, 2),
+			       EndgameSolver::Clock::now() + std::chrono::seconds(5), row, col);
+    check(!solved, "no consistent layout: solve() gives up");
+}
+
+int main() {
+    testHitMustBeCovered();
+    testNoConsistentLayout();
+    if( failures == 0 ) {
+	cout << "EndgameSolver: all checks passed" << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+/**
+ * @brief Board geometry, loaded from a config file.
+ * @file GameConfig.cpp
+ */
+
+#include <fstream>
+#include <sstream>
+
+#include "defines.h"
+#include "GameConfig.h"
+
+static string trim(const string& text) {
+    string::size_type first = text.find_first_not_of(" \t\r");
+    if( first == string::npos ) {
+	return "";
+    }
+    string::size_type last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+bool loadGameConfig(const string& path, GameConfig& config, string& error) {
+    ifstream in(path.c_str());
+    if( !in ) {
+	error = "could not open " + path;
+	return false;
+    }
+
+    config.rows = 0;
+    config.cols = 0;
+
+    string line;
+    int lineNumber = 0;
+    while( getline(in, line) ) {
+	lineNumber++;
+	line = trim(line.substr(0, line.find('#')));
+	if( line.empty() ) {
+	    continue;
+	}
+
+	ostringstream where;
+	where << path << ":" << lineNumber << ": ";
+	string::size_type equals = line.find('=');
+	if( equals == string::npos ) {
+	    error = where.str() + "expected key = value";
+	    return false;
+	}
+	string key = trim(line.substr(0, equals));
+	istringstream value(line.substr(equals + 1));
+
+	if( key == "rows" ) {
+	    value >> config.rows;
+	} else if( key == "cols" ) {
+	    value >> config.cols;
+	} else if( key == "size" ) {
+	    value >> config.rows;
+	    config.cols = config.rows;
+	} else if( key == "fleet" ) {
+	    error = where.str() + "the fleet is fixed by the contest engine and can't be configured";
+	    return false;
+	} else {
+	    error = where.str() + "unknown key '" + key + "'";
+	    return false;
+	}
+	if( !value ) {
+	    error = where.str() + "expected a number for " + key;
+	    return false;
+	}
+    }
+
+    if( config.rows < 3 || config.rows > MAX_BOARD_SIZE || config.cols < 3 || config.cols > MAX_BOARD_SIZE ) {
+	ostringstream message;
+	message << path << ": rows and cols must be between 3 and " << MAX_BOARD_SIZE;
+	error = message.str();
+	return false;
+    }
+    return true;
+}
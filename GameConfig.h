@@ -0,0 +1,34 @@
+/**
+ * @brief Board geometry, loaded from a config file.
+ * @file GameConfig.h
+ *
+ * Config files are lines of "key = value"; blank lines and anything after a
+ * '#' are ignored. Recognized keys:
+ *   rows  = number of board rows (3 to MAX_BOARD_SIZE)
+ *   cols  = number of board columns (3 to MAX_BOARD_SIZE)
+ *   size  = shorthand for a square board: sets rows and cols
+ *
+ * The fleet can't be configured: AIContest always places its own built-in
+ * fleet and doesn't say what it is, so a "fleet" key is rejected rather than
+ * silently ignored. Players learn the fleet from placeShip() as before.
+ */
+
+#ifndef GAMECONFIG_H		// Double inclusion protection
+#define GAMECONFIG_H
+
+#include <string>
+
+using namespace std;
+
+struct GameConfig {
+    int rows;
+    int cols;
+};
+
+/**
+ * @brief Reads and validates a config file.
+ * @param error Set to a description of the problem when false is returned.
+ */
+bool loadGameConfig(const string& path, GameConfig& config, string& error);
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @brief Optional interfaces a PlayerV2 can implement to get more from the contest.
+ * @file PlayerExtensions.h
+ *
+ * PlayerV2 itself is shared with the prebuilt players, so anything beyond it is
+ * offered as a separate interface. The contest driver checks for these with
+ * dynamic_cast and simply skips players that don't implement them.
+ */
+
+#ifndef PLAYEREXTENSIONS_H		// Double inclusion protection
+#define PLAYEREXTENSIONS_H
+
+#include <string>
+#include <chrono>
+#include <cstddef>
+
+#include "Message.h"
+#include "GameConfig.h"
+
+/**
+ * @brief Players that want to know who they are about to play.
+ * setOpponent() is called before the first round of every match.
+ */
+class OpponentAware {
+    public:
+	virtual ~OpponentAware() {}
+	virtual void setOpponent(const std::string& opponentName) = 0;
+};
+
+/**
+ * @brief Players that can play on a board other than the square one they were
+ * created for. setGameConfig() is called between rounds with the new geometry.
+ * The contest engine only plays square boards of the size players are created
+ * with, so the contest itself never calls this; drivers that vary the geometry,
+ * such as YuBellPlayerTest, do.
+ */
+class ConfigAware {
+    public:
+	virtual ~ConfigAware() {}
+	virtual void setGameConfig(const GameConfig& config) = 0;
+};
+
+/**
+ * @brief Players that can make use of a per-move time budget.
+ * When the contest has a move budget, it calls getMove(deadline) instead of
+ * getMove() and expects the move back by the deadline. Without a budget, or
+ * for players that don't implement this, plain getMove() is used.
+ */
+class DeadlineAware {
+    public:
+	typedef std::chrono::steady_clock Clock;
+
+	virtual ~DeadlineAware() {}
+	virtual Message getMove(Clock::time_point deadline) = 0;
+};
+
+/**
+ * @brief One update for a player, as plain data: no string, no allocation.
+ * Carries what update(Message) needs; the Message string is dropped.
+ */
+struct PlayerEvent {
+    char type;			// HIT, MISS, KILL, OPPONENT_SHOT, WIN, LOSE or TIE
+    signed char row;
+    signed char col;
+    signed char length;
+    Direction direction;
+
+    static PlayerEvent fromMessage(const Message& msg) {
+	PlayerEvent event = { (char)msg.getMessageType(), (signed char)msg.getRow(),
+			      (signed char)msg.getCol(), (signed char)msg.getLength(),
+			      msg.getDirection() };
+	return event;
+    }
+};
+
+/**
+ * @brief Players that can take all of a turn's updates in one call.
+ * The contest collects the updates for a player and delivers them, in order,
+ * just before the player is next asked for something, and at the end of each
+ * round. Players that don't implement this get each Message as it arrives.
+ */
+class BatchUpdatable {
+    public:
+	virtual ~BatchUpdatable() {}
+	virtual void update(const PlayerEvent* events, size_t count) = 0;
+};
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ * @brief Buffered, asynchronous writer for machine-readable contest results.
+ * @file ResultsSink.cpp
+ */
+
+#include <sstream>
+#include <chrono>
+
+#include "ResultsSink.h"
+
+// The writer thread is woken once this much output is pending; otherwise it
+// flushes whatever it has about once a second.
+static const size_t FLUSH_THRESHOLD = 64 * 1024;
+
+// CSV header rows, one per record kind; the columns match the write() calls below
+static const char* CSV_HEADERS[] = {
+    "record,match,game,player1,player2,winner,shots,player1_seconds,player2_seconds,seed",
+    "record,match,player1,player2,player1_wins,player2_wins,ties,player1_avg_shots,player2_avg_shots,"
+	"player1_lives,player2_lives",
+    "record,rank,player,lives,wins,tied",
+};
+
+ResultsSink::ResultsSink()
+    : format(JSON_RESULTS), accepting(false), closing(false)
+{
+}
+
+ResultsSink::~ResultsSink() {
+    close();
+}
+
+/**
+ * @brief Opens the results file and starts the writer thread.
+ * @return false if the file could not be created.
+ */
+bool ResultsSink::open(const string& path, ResultsFormat format) {
+    close();
+    out.open(path.c_str(), ios::out | ios::trunc);
+    if( !out ) {
+	return false;
+    }
+    this->format = format;
+    for( int kind=0; kind<NUM_RECORD_KINDS; kind++ ) {
+	headerWritten[kind] = false;
+    }
+    accepting = true;
+    resume();
+    return true;
+}
+
+bool ResultsSink::isOpen() const {
+    return accepting;
+}
+
+/**
+ * @brief Writes out everything still pending and closes the file.
+ */
+void ResultsSink::close() {
+    if( !accepting ) {
+	return;
+    }
+    pause();
+    out << pending;
+    pending.clear();
+    out.close();
+    accepting = false;
+}
+
+/**
+ * @brief Stops the writer thread, after it has written what is pending.
+ * Records written while paused are kept until resume() or close().
+ */
+void ResultsSink::pause() {
+    if( !writer.joinable() ) {
+	return;
+    }
+    {
+	lock_guard<mutex> guard(bufferLock);
+	closing = true;
+    }
+    bufferReady.notify_one();
+    writer.join();
+}
+
+/**
+ * @brief Restarts the writer thread after pause().
+ */
+void ResultsSink::resume() {
+    if( !accepting || writer.joinable() ) {
+	return;
+    }
+    closing = false;
+    writer = thread(&ResultsSink::writerLoop, this);
+}
+
+void ResultsSink::write(const GameRecord& record) {
+    ostringstream line;
+    line << field("record", "game", true)
+	 << field("match", record.match)
+	 << field("game", record.game)
+	 << field("player1", quoted(record.player1))
+	 << field("player2", quoted(record.player2))
+	 << field("winner", quoted(record.winner))
+	 << field("shots", record.shots)
+	 << field("player1_seconds", record.player1Seconds)
+	 << field("player2_seconds", record.player2Seconds)
+	 << field("seed", record.seed);
+    append(GAME_RECORD, line.str());
+}
+
+void ResultsSink::write(const MatchRecord& record) {
+    ostringstream line;
+    line << field("record", "match", true)
+	 << field("match", record.match)
+	 << field("player1", quoted(record.player1))
+	 << field("player2", quoted(record.player2))
+	 << field("player1_wins", record.player1Wins)
+	 << field("player2_wins", record.player2Wins)
+	 << field("ties", record.ties)
+	 << field("player1_avg_shots", record.player1AvgShots)
+	 << field("player2_avg_shots", record.player2AvgShots)
+	 << field("player1_lives", record.player1Lives)
+	 << field("player2_lives", record.player2Lives);
+    append(MATCH_RECORD, line.str());
+}
+
+void ResultsSink::write(const StandingRecord& record) {
+    ostringstream line;
+    line << field("record", "standing", true)
+	 << field("rank", record.rank)
+	 << field("player", quoted(record.player))
+	 << field("lives", record.lives)
+	 << field("wins", record.wins)
+	 << field("tied", string(record.tied ? "true" : "false"));
+    append(STANDING_RECORD, line.str());
+}
+
+/*
+ * Queues one finished record for the writer thread, after its kind's CSV
+ * header row if this is the first record of that kind.
+ */
+void ResultsSink::append(RecordKind kind, const string& line) {
+    if( !accepting ) {
+	return;
+    }
+    bool wake;
+    {
+	lock_guard<mutex> guard(bufferLock);
+	if( format == CSV_RESULTS && !headerWritten[kind] ) {
+	    pending += CSV_HEADERS[kind];
+	    pending += "\n";
+	    headerWritten[kind] = true;
+	}
+	pending += line;
+	pending += (format == JSON_RESULTS ? "}\n" : "\n");
+	wake = pending.size() >= FLUSH_THRESHOLD;
+    }
+    if( wake ) {
+	bufferReady.notify_one();
+    }
+}
+
+/*
+ * Body of the writer thread: swaps the pending buffer out under the lock and
+ * does the actual file I/O without holding it.
+ */
+void ResultsSink::writerLoop() {
+    string batch;
+    bool done = false;
+    while( !done ) {
+	{
+	    unique_lock<mutex> guard(bufferLock);
+	    bufferReady.wait_for(guard, chrono::seconds(1), [this] {
+		return closing || pending.size() >= FLUSH_THRESHOLD;
+	    });
+	    batch.swap(pending);
+	    done = closing;
+	}
+	if( !batch.empty() ) {
+	    out << batch;
+	    out.flush();
+	    batch.clear();
+	}
+    }
+}
+
+/*
+ * Quotes a string for the current format. Both CSV and JSON use double quotes;
+ * CSV doubles embedded quotes, JSON backslash-escapes them.
+ */
+string ResultsSink::quoted(const string& text) const {
+    string result = "\"";
+    for( string::size_type i=0; i<text.size(); i++ ) {
+	char ch = text[i];
+	if( ch == '"' ) {
+	    result += (format == JSON_RESULTS ? "\\\"" : "\"\"");
+	} else if( ch == '\\' && format == JSON_RESULTS ) {
+	    result += "\\\\";
+	} else if( (unsigned char)ch < 0x20 ) {
+	    result += ' ';
+	} else {
+	    result += ch;
+	}
+    }
+    return result + "\"";
+}
+
+/*
+ * Formats one field: ",value" for CSV or ,"name":value for JSON. The first
+ * field of a record opens the JSON object instead of adding a separator; its
+ * value is the record kind, which is quoted for JSON and bare for CSV.
+ */
+string ResultsSink::field(const string& name, const string& value, bool first) const {
+    if( format == CSV_RESULTS ) {
+	return first ? value : "," + value;
+    }
+    if( first ) {
+	return "{\"" + name + "\":\"" + value + "\"";
+    }
+    return ",\"" + name + "\":" + value;
+}
+
+string ResultsSink::field(const string& name, double value) const {
+    ostringstream text;
+    text.precision(9);
+    text << value;
+    return field(name, text.str());
+}
+
+string ResultsSink::field(const string& name, int value) const {
+    ostringstream text;
+    text << value;
+    return field(name, text.str());
+}
+
+string ResultsSink::field(const string& name, unsigned int value) const {
+    ostringstream text;
+    text << value;
+    return field(name, text.str());
+}
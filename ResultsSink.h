@@ -0,0 +1,109 @@
+/**
+ * @brief Machine-readable contest results (CSV or JSON lines).
+ * @file ResultsSink.h
+ *
+ * The contest driver reports one record per game, one per match and one per
+ * final standing. Records are formatted on the caller's thread and appended
+ * to an in-memory buffer; a background writer thread drains the buffer to the
+ * output file, so a slow disk never stalls the games themselves.
+ *
+ * The writer thread must not be running when the process forks: pause()
+ * stops it (records written meanwhile are kept) and resume() restarts it.
+ *
+ * CSV output starts every row with the record kind ("game", "match" or
+ * "standing"); the remaining columns are fixed per kind, in the order the
+ * fields are declared below. The kinds have different columns, so each gets
+ * its own header row, written just before its first record; header rows start
+ * with "record". To load one kind into a CSV tool, keep its header row and the
+ * rows starting with its name. JSON lines output writes one object per line
+ * with a "record" key holding the kind.
+ */
+
+#ifndef RESULTSSINK_H		// Double inclusion protection
+#define RESULTSSINK_H
+
+#include <string>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+enum ResultsFormat { CSV_RESULTS, JSON_RESULTS };
+
+struct GameRecord {
+    int match;
+    int game;
+    string player1;
+    string player2;
+    string winner;		// Player name, or "tie"
+    int shots;
+    double player1Seconds;	// Time spent inside player1's methods
+    double player2Seconds;
+    unsigned int seed;		// Value passed to srand() before the game
+};
+
+struct MatchRecord {
+    int match;
+    string player1;
+    string player2;
+    int player1Wins;
+    int player2Wins;
+    int ties;
+    double player1AvgShots;	// Cumulative avg. shots/game, as printed
+    double player2AvgShots;
+    int player1Lives;		// Lives left after the match
+    int player2Lives;
+};
+
+struct StandingRecord {
+    int rank;
+    string player;
+    int lives;
+    int wins;
+    bool tied;
+};
+
+class ResultsSink {
+    public:
+	ResultsSink();
+	~ResultsSink();
+
+	bool open(const string& path, ResultsFormat format);
+	bool isOpen() const;
+	void close();
+	void pause();
+	void resume();
+
+	void write(const GameRecord& record);
+	void write(const MatchRecord& record);
+	void write(const StandingRecord& record);
+
+    private:
+	ResultsSink(const ResultsSink&);		// Not copyable
+	ResultsSink& operator=(const ResultsSink&);
+
+	enum RecordKind { GAME_RECORD, MATCH_RECORD, STANDING_RECORD, NUM_RECORD_KINDS };
+
+	void append(RecordKind kind, const string& line);
+	void writerLoop();
+
+	string quoted(const string& text) const;
+	string field(const string& name, const string& value, bool first = false) const;
+	string field(const string& name, double value) const;
+	string field(const string& name, int value) const;
+	string field(const string& name, unsigned int value) const;
+
+	ResultsFormat format;
+	ofstream out;
+	thread writer;
+	mutex bufferLock;
+	condition_variable bufferReady;
+	string pending;		// Lines waiting for the writer thread
+	bool headerWritten[NUM_RECORD_KINDS];	// CSV: header rows already queued
+	bool accepting;		// Between open() and close(), paused or not
+	bool closing;
+};
+
+#endif
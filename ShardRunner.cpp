@@ -0,0 +1,145 @@
+/**
+ * @brief Splitting a tournament into shards and running them in worker processes.
+ * @file ShardRunner.cpp
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "ShardRunner.h"
+
+string formatShard(const GameShard& shard) {
+    ostringstream line;
+    line << "shard " << shard.match << " " << shard.player1Id << " " << shard.player2Id << " "
+	 << shard.boardSize << " " << shard.firstGame << " " << shard.endGame << " " << shard.seed;
+    if( shard.moveBudget > 0 ) {
+	line.precision(17);
+	line << " " << shard.moveBudget;
+    }
+    return line.str();
+}
+
+bool parseShard(const string& line, GameShard& shard) {
+    istringstream fields(line);
+    string kind;
+    fields >> kind >> shard.match >> shard.player1Id >> shard.player2Id
+	   >> shard.boardSize >> shard.firstGame >> shard.endGame >> shard.seed;
+    if( !fields || kind != "shard" ) {
+	return false;
+    }
+    if( !(fields >> shard.moveBudget) ) {
+	shard.moveBudget = 0;
+    }
+    return true;
+}
+
+string formatShardResult(const ShardResult& result) {
+    ostringstream line;
+    line << "result " << result.match << " " << result.player1Id << " " << result.player2Id << " "
+	 << result.player1Wins << " " << result.player2Wins << " " << result.ties << " "
+	 << result.player1Shots << " " << result.player1Games << " "
+	 << result.player2Shots << " " << result.player2Games;
+    return line.str();
+}
+
+bool parseShardResult(const string& line, ShardResult& result) {
+    istringstream fields(line);
+    string kind;
+    fields >> kind >> result.match >> result.player1Id >> result.player2Id
+	   >> result.player1Wins >> result.player2Wins >> result.ties
+	   >> result.player1Shots >> result.player1Games
+	   >> result.player2Shots >> result.player2Games;
+    return fields && kind == "result";
+}
+
+/*
+ * Each worker writes "<job index> <output line>" lines to its own pipe. The
+ * parent reads the pipes one after the other; a worker that fills its pipe
+ * just waits until the parent gets to it.
+ */
+bool runInWorkers(int workers, const vector<string>& jobs, string (*work)(const string& job),
+		  vector<string>& output) {
+    if( workers < 1 ) {
+	workers = 1;
+    }
+    output.assign(jobs.size(), "");
+    vector<pid_t> pids;
+    vector<int> pipes;
+
+    // Anything still buffered would otherwise be written once per worker too
+    cout.flush();
+    cerr.flush();
+    fflush(NULL);
+
+    for( int worker=0; worker<workers; worker++ ) {
+	int fds[2];
+	if( pipe(fds) != 0 ) {
+	    perror("pipe");
+	    break;
+	}
+	pid_t pid = fork();
+	if( pid < 0 ) {
+	    perror("fork");
+	    close(fds[0]);
+	    close(fds[1]);
+	    break;
+	}
+	if( pid == 0 ) {
+	    close(fds[0]);
+	    for( size_t job=worker; job<jobs.size(); job+=workers ) {
+		ostringstream line;
+		line << job << " " << work(jobs[job]) << "\n";
+		string text = line.str();
+		const char* data = text.c_str();
+		size_t left = text.size();
+		while( left > 0 ) {
+		    ssize_t written = write(fds[1], data, left);
+		    if( written <= 0 ) {
+			_exit(1);
+		    }
+		    data += written;
+		    left -= written;
+		}
+	    }
+	    close(fds[1]);
+	    _exit(0);	// Skip the parent's atexit handlers and destructors
+	}
+	close(fds[1]);
+	pids.push_back(pid);
+	pipes.push_back(fds[0]);
+    }
+
+    for( size_t i=0; i<pipes.size(); i++ ) {
+	string text;
+	char buffer[4096];
+	ssize_t got;
+	while( (got = read(pipes[i], buffer, sizeof buffer)) > 0 ) {
+	    text.append(buffer, got);
+	}
+	close(pipes[i]);
+
+	istringstream lines(text);
+	string line;
+	while( getline(lines, line) ) {
+	    size_t space = line.find(' ');
+	    size_t job = strtoul(line.c_str(), NULL, 10);
+	    if( space != string::npos && job < jobs.size() ) {
+		output[job] = line.substr(space + 1);
+	    }
+	}
+    }
+
+    bool ok = (int)pids.size() == workers;
+    for( size_t i=0; i<pids.size(); i++ ) {
+	int status;
+	if( waitpid(pids[i], &status, 0) != pids[i] || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ) {
+	    ok = false;
+	}
+    }
+    return ok;
+}
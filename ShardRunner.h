@@ -0,0 +1,68 @@
+/**
+ * @brief Splitting a tournament into shards and running them in worker processes.
+ * @file ShardRunner.h
+ *
+ * A shard is a contiguous range of games from one match, together with the
+ * seed its first game uses. Shards and their results are plain text lines, so
+ * they can be written to a file and run somewhere else with
+ * './contest --shard-file=FILE'; runInWorkers() runs them in forked local
+ * processes. Each worker builds its own players, so the prebuilt players'
+ * global state never leaks between shards.
+ *
+ * Shard line:  shard <match> <player1> <player2> <boardSize> <firstGame> <endGame> <seed> [<moveBudget>]
+ * Result line: result <match> <player1> <player2> <player1Wins> <player2Wins> <ties>
+ *              <player1Shots> <player1Games> <player2Shots> <player2Games>
+ * Games run from firstGame up to, but not including, endGame; game g is seeded
+ * with seed + (g - firstGame). moveBudget is the per-move time limit in
+ * seconds; 0, or leaving it off, means unlimited.
+ */
+
+#ifndef SHARDRUNNER_H		// Double inclusion protection
+#define SHARDRUNNER_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct GameShard {
+    int match;
+    int player1Id;
+    int player2Id;
+    int boardSize;
+    int firstGame;
+    int endGame;
+    unsigned int seed;
+    double moveBudget;
+};
+
+struct ShardResult {
+    int match;
+    int player1Id;
+    int player2Id;
+    int player1Wins;
+    int player2Wins;
+    int ties;
+    long player1Shots;		// Shots in the games counted for player1 (wins and ties)
+    int player1Games;
+    long player2Shots;
+    int player2Games;
+};
+
+string formatShard(const GameShard& shard);
+bool parseShard(const string& line, GameShard& shard);
+string formatShardResult(const ShardResult& result);
+bool parseShardResult(const string& line, ShardResult& result);
+
+/**
+ * @brief Runs jobs in forked worker processes and collects their output.
+ * @param workers Number of processes; worker w runs jobs w, w+workers, ...
+ * @param jobs One line of input per job.
+ * @param work Called in the worker for each job; returns that job's output line.
+ * @param output Set to the output lines, in job order.
+ * @return false if a worker could not be started or did not exit cleanly.
+ */
+bool runInWorkers(int workers, const vector<string>& jobs, string (*work)(const string& job),
+		  vector<string>& output);
+
+#endif
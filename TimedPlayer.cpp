@@ -0,0 +1,87 @@
+/**
+ * @brief PlayerV2 wrapper that measures how long the wrapped player thinks.
+ * @file TimedPlayer.cpp
+ */
+
+#include "TimedPlayer.h"
+
+TimedPlayer::TimedPlayer( PlayerV2* player, int boardSize )
+    :PlayerV2(boardSize), player(player), pendingCount(0), elapsed(Clock::duration::zero()),
+     moveBudget(Clock::duration::zero())
+{
+    deadlinePlayer = dynamic_cast<DeadlineAware*>(player);
+    batchPlayer = dynamic_cast<BatchUpdatable*>(player);
+}
+
+/*
+ * Anything still queued belongs to the player, which usually outlives us.
+ */
+TimedPlayer::~TimedPlayer() {
+    deliverEvents();
+}
+
+void TimedPlayer::newRound() {
+    Clock::time_point start = Clock::now();
+    deliverEvents();
+    player->newRound();
+    elapsed += Clock::now() - start;
+}
+
+Message TimedPlayer::placeShip(int length) {
+    Clock::time_point start = Clock::now();
+    deliverEvents();
+    Message result = player->placeShip(length);
+    elapsed += Clock::now() - start;
+    return result;
+}
+
+Message TimedPlayer::getMove() {
+    Clock::time_point start = Clock::now();
+    deliverEvents();
+    Message result = (deadlinePlayer != NULL && moveBudget > Clock::duration::zero())
+	? deadlinePlayer->getMove(start + moveBudget)
+	: player->getMove();
+    elapsed += Clock::now() - start;
+    return result;
+}
+
+void TimedPlayer::update(Message msg) {
+    if( batchPlayer == NULL ) {
+	Clock::time_point start = Clock::now();
+	player->update(msg);
+	elapsed += Clock::now() - start;
+	return;
+    }
+
+    pending[pendingCount++] = PlayerEvent::fromMessage(msg);
+    char type = msg.getMessageType();
+    if( pendingCount == MAX_PENDING_EVENTS || type == WIN || type == LOSE || type == TIE ) {
+	// Deliver the end of a round now, so its time is charged to that game
+	Clock::time_point start = Clock::now();
+	deliverEvents();
+	elapsed += Clock::now() - start;
+    }
+}
+
+/*
+ * Hands the queued updates to a BatchUpdatable player in one call.
+ */
+void TimedPlayer::deliverEvents() {
+    if( pendingCount == 0 ) {
+	return;
+    }
+    batchPlayer->update(pending, pendingCount);
+    pendingCount = 0;
+}
+
+double TimedPlayer::getSeconds() const {
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+void TimedPlayer::resetClock() {
+    elapsed = Clock::duration::zero();
+}
+
+void TimedPlayer::setMoveBudget(double seconds) {
+    moveBudget = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+}
@@ -0,0 +1,56 @@
+/**
+ * @brief PlayerV2 wrapper that measures how long the wrapped player thinks.
+ * @file TimedPlayer.h
+ *
+ * The contest hands a TimedPlayer to AIContest in place of the real player.
+ * Every call is forwarded unchanged; the wall-clock time spent inside the
+ * wrapped player is accumulated until resetClock() is called.
+ *
+ * With a move budget set, players implementing DeadlineAware get their
+ * getMove(deadline) called instead of getMove().
+ *
+ * For players implementing BatchUpdatable, updates are queued as PlayerEvents
+ * and delivered in one call just before the next newRound(), placeShip() or
+ * getMove(), at once when a round ends, and when the TimedPlayer is destroyed.
+ * Other players get each Message forwarded as it arrives. The wrapped player
+ * must outlive its TimedPlayer.
+ */
+
+#ifndef TIMEDPLAYER_H		// Double inclusion protection
+#define TIMEDPLAYER_H
+
+#include <chrono>
+
+#include "PlayerV2.h"
+#include "PlayerExtensions.h"
+#include "Message.h"
+
+class TimedPlayer: public PlayerV2 {
+    public:
+	TimedPlayer( PlayerV2* player, int boardSize );
+	~TimedPlayer();
+	void newRound();
+	Message placeShip(int length);
+	Message getMove();
+	void update(Message msg);
+
+	double getSeconds() const;	// Time spent in the player since resetClock()
+	void resetClock();
+	void setMoveBudget(double seconds);	// 0 means no budget
+
+    private:
+	typedef std::chrono::steady_clock Clock;
+
+	void deliverEvents();
+
+	PlayerV2* player;
+	DeadlineAware* deadlinePlayer;	// Same object as player, if it takes deadlines
+	BatchUpdatable* batchPlayer;	// Same object as player, if it takes batches
+	static const size_t MAX_PENDING_EVENTS = 64;
+	PlayerEvent pending[MAX_PENDING_EVENTS];	// Updates not yet delivered, oldest first
+	size_t pendingCount;
+	Clock::duration elapsed;
+	Clock::duration moveBudget;
+};
+
+#endif
@@ -12,16 +12,34 @@
 #include <cstdlib>
 #include <algorithm>
 #include <stack>
+#include <new>
 
 #include "conio.h"
 #include "YuBellPlayer.h"
 
 using namespace conio;
 
+//by default, solve exactly once no more than this many cells are still unknown
+static const int DEFAULT_ENDGAME_THRESHOLD = 20;
+
+//arrival times run from 0 (the opponent's first shot) to ARRIVAL_NEVER (not shot that round);
+//each round moves a cell's average 1/ARRIVAL_SMOOTHING of the way to what happened
+static const int ARRIVAL_NEVER = UINT16_MAX;
+static const int ARRIVAL_SMOOTHING = 8;
+
+map<int, vector<Placement> > YuBellPlayer::placementTables;
+mutex YuBellPlayer::placementTablesLock;
+
 bool Ship::operator<( const Ship &ship ) const {
   return score < ship.score;
 }
 
+YuBellParams::YuBellParams()
+  : attackWeight(4), placementWeight(3), adjacencyPenalty(1000), topPlacements(5),
+    topPlacementBoost(1.0), cornerValue(2), edgeValue(3), ringStep(1), arrivalWeight(2.0)
+{
+}
+
 /**
  * @brief Constructor that initializes any inter-round data structures.
  * @param boardSize Indication of the size of the board that is in use.
@@ -35,78 +53,217 @@ YuBellPlayer::YuBellPlayer( int boardSize )
     :PlayerV2(boardSize)
 {
     // Initialize inter-round structures
+    this->cells = NULL;
+    resizeBoard(boardSize, boardSize);
     this->currentRound = 0;
     this->emptyPoint = {-1, -1};
-    initializeProbMap(this->opponentsHits);
-    initializeProbMap(this->attackProbabilities);
+    this->model = NULL;
+    this->opponentShots = 0;
+    this->arrivalsPending = false;
+    setOpponent(""); //until we're told who we're playing
+    this->endgameThreshold = DEFAULT_ENDGAME_THRESHOLD;
+    for (int d = 0; d < MAX_BOARD_SIZE; d++) {
+      this->missReach[d] = 0;
+    }
+    for (int length = 0; length <= MAX_BOARD_SIZE; length++) {
+      this->shipLengthCounts[length] = 0;
+    }
 
     srand(time(NULL));
 }
 
 /**
- * @brief Destructor placeholder.
- * If your code does anything that requires cleanup when the object is
- * destroyed, do it here in the destructor.
+ * @brief Destructor: releases the per-round cells.
+ */
+YuBellPlayer::~YuBellPlayer( ) {
+    free(this->cells);
+}
+
+/**
+ * @brief Approximate memory used by this player: the object itself plus the
+ * per-round cells, opponent models and ship lists it owns. Doesn't count the
+ * placement tables, which every instance shares, or the endgame solver's
+ * scratch space, which is only filled while solving.
  */
-YuBellPlayer::~YuBellPlayer( ) {}
+size_t YuBellPlayer::memoryFootprint() const {
+    size_t bytes = sizeof(*this);
+    bytes += boardRows * boardCols * sizeof(CellState);
+    //models, ignoring the container nodes around them
+    for (OpponentModelList::const_iterator it = opponentModels.begin(); it != opponentModels.end(); ++it) {
+      bytes += sizeof(*it) + it->first.capacity();
+    }
+    bytes += hits.capacity() * sizeof(Point);
+    bytes += shipsAfloat.capacity() * sizeof(int);
+    return bytes;
+}
 
 /*
- * Private internal function that initializes a MAX_BOARD_SIZE 2D array of char to water.
+ * Sizes the per-round cell state to the board. getMove() and the updates walk
+ * these cells constantly, so they start on a cache line boundary.
  */
-void YuBellPlayer::initializeBoard() {
-    for(int row=0; row<boardSize; row++) {
-	     for(int col=0; col<boardSize; col++) {
-	        this->board[row][col] = WATER;
-	     }
+void YuBellPlayer::resizeBoard(int rows, int cols) {
+    void* buffer = NULL;
+    if (posix_memalign(&buffer, 64, rows * cols * sizeof(CellState)) != 0) {
+      throw bad_alloc();
     }
+    free(this->cells);
+    this->cells = (CellState*)buffer;
+    fill(cells, cells + rows * cols, CellState());
+    this->boardRows = rows;
+    this->boardCols = cols;
 }
 
-void YuBellPlayer::initializeShipsPlaced() {
-  for(int row=0; row<boardSize; row++) {
-     for(int col=0; col<boardSize; col++) {
-        this->shipsPlaced[row][col] = 0;
-     }
-  }
+/**
+ * @brief Switches to what we have learned about the named opponent.
+ * @param opponentName Name of the player we are about to play.
+ *
+ * Called between rounds. Models for the most recently seen opponents are kept,
+ * so switching back to one of them is a lookup and a list splice; a new
+ * opponent evicts the least recently used model once the cache is full.
+ */
+void YuBellPlayer::setOpponent(const string& opponentName) {
+    foldArrivals();
+    unordered_map<string, OpponentModelList::iterator>::iterator found = opponentModelIndex.find(opponentName);
+    if (found != opponentModelIndex.end()) {
+      opponentModels.splice(opponentModels.begin(), opponentModels, found->second);
+    }
+    else if (currentRound == 0 && opponentModels.size() == 1 && opponentModels.front().first.empty()) {
+      //nothing has been learned under the constructor's placeholder name yet, so it can be renamed
+      opponentModelIndex.clear();
+      opponentModels.front().first = opponentName;
+      opponentModelIndex[opponentName] = opponentModels.begin();
+    }
+    else {
+      if (opponentModels.size() >= MAX_OPPONENT_MODELS) {
+        opponentModelIndex.erase(opponentModels.back().first);
+        opponentModels.pop_back();
+      }
+      opponentModels.push_front(make_pair(opponentName, OpponentModel()));
+      initializeProbMap(opponentModels.front().second.opponentsHits);
+      initializeProbMap(opponentModels.front().second.attackProbabilities);
+      for (int row = 0; row < MAX_BOARD_SIZE; row++) {
+        for (int col = 0; col < MAX_BOARD_SIZE; col++) {
+          opponentModels.front().second.arrivalTimes[row][col] = ARRIVAL_NEVER;
+        }
+      }
+      opponentModelIndex[opponentName] = opponentModels.begin();
+    }
+    this->model = &opponentModels.front().second;
 }
 
-void YuBellPlayer::initializeProbMap(int probMap[MAX_BOARD_SIZE][MAX_BOARD_SIZE]) {
-  int edge = boardSize - 1;
+/**
+ * @brief Switches to a board of the given geometry. Call between rounds.
+ *
+ * A different geometry means the opponent models no longer line up with the
+ * board, so they are dropped.
+ */
+void YuBellPlayer::setGameConfig(const GameConfig& config) {
+    if (config.rows != boardRows || config.cols != boardCols) {
+      arrivalsPending = false;
+      resizeBoard(config.rows, config.cols);
+      opponentModels.clear();
+      opponentModelIndex.clear();
+      setOpponent("");
+    }
+}
 
-	//corners
-	probMap[0][0] = 2;
-	probMap[0][edge] = 2;
-	probMap[edge][0] = 2;
-	probMap[edge][edge] = 2;
-
-	//edges
-	for (int i = 1; i < edge; i++) {
-		probMap[0][i] = 3;
-		probMap[edge][i] = 3;
-		probMap[i][0] = 3;
-		probMap[i][edge] = 3;
-	}
+void YuBellPlayer::setEndgameThreshold(int unknownCells) {
+    this->endgameThreshold = unknownCells;
+}
 
-	//the rest of the board, with increasing probabilities as we get closer to the center
-	for (int round = 1; round < (boardSize/2); ++round) {
-		for (int i = round; i <= edge - round; ++i) {
-			probMap[round][i] = round + 3;
-			probMap[i][round] = round + 3;
-			probMap[edge - round][i] = round + 3;
-			probMap[i][edge - round] = round + 3;
+/**
+ * @brief Replaces the tuning constants. Call between rounds.
+ * The opponent models were seeded and learned with the old constants, so they start over.
+ */
+void YuBellPlayer::setParams(const YuBellParams& params) {
+    this->params = params;
+    arrivalsPending = false;
+    opponentModels.clear();
+    opponentModelIndex.clear();
+    setOpponent("");
+}
+
+/*
+ * Fills a probability map in rings: cornerValue (2) in the corners, edgeValue (3)
+ * along the edges, and ringStep (1) more for every ring closer to the center. The
+ * single center cell of an odd square board gets one less than its ring would.
+ */
+void YuBellPlayer::initializeProbMap(uint16_t probMap[MAX_BOARD_SIZE][MAX_BOARD_SIZE]) {
+  int lastRow = boardRows - 1;
+  int lastCol = boardCols - 1;
+
+	for (int row = 0; row < boardRows; ++row) {
+		for (int col = 0; col < boardCols; ++col) {
+			int ring = min(min(row, col), min(lastRow - row, lastCol - col));
+			probMap[row][col] = params.edgeValue + ring * params.ringStep;
 		}
 	}
 
-	//if the boardSize is odd, there will be one last center position to put a probability in
-	if ((boardSize % 2) == 1) {
-		probMap[boardSize/2][boardSize/2] = (boardSize/2) + 2;
+	//corners
+	probMap[0][0] = params.cornerValue;
+	probMap[0][lastCol] = params.cornerValue;
+	probMap[lastRow][0] = params.cornerValue;
+	probMap[lastRow][lastCol] = params.cornerValue;
+
+	//if the board is square and odd, there will be one last center position to put a probability in
+	if (boardRows == boardCols && (boardRows % 2) == 1) {
+		probMap[boardRows/2][boardCols/2] = params.edgeValue + (boardRows/2) * params.ringStep - 1;
 	}
 }
 
+/*
+ * Adds one to a learned counter. If it is already at its maximum, the whole map is halved first;
+ * halving never takes a counter below 1, since placement scores are divided by.
+ */
+void YuBellPlayer::bumpCounter(uint16_t counters[MAX_BOARD_SIZE][MAX_BOARD_SIZE], int row, int col) {
+  if (counters[row][col] == UINT16_MAX) {
+    for (int r = 0; r < MAX_BOARD_SIZE; r++) {
+      for (int c = 0; c < MAX_BOARD_SIZE; c++) {
+        counters[r][c] = max(1, counters[r][c] / 2);
+      }
+    }
+  }
+  counters[row][col]++;
+}
+
+/*
+ * Records the opponent's shot in the arrival model, if it is their first at that cell this round.
+ */
+void YuBellPlayer::opponentShotAt(int row, int col) {
+  if (onBoard(row, col) && !cell(row, col).opponentShot) {
+    cell(row, col).opponentShot = 1;
+    int observed = min(ARRIVAL_NEVER - 1, opponentShots * ARRIVAL_NEVER / (boardRows * boardCols));
+    uint16_t& average = model->arrivalTimes[row][col];
+    average = average + (observed - average) / ARRIVAL_SMOOTHING;
+  }
+  opponentShots++;
+}
+
+/*
+ * Ends the round in the arrival model: cells the opponent never shot count as
+ * reached last. Runs once per round, at whichever comes first of the round's
+ * end message, the next newRound() and a switch to another opponent.
+ */
+void YuBellPlayer::foldArrivals() {
+  if (!arrivalsPending) {
+    return;
+  }
+  for (int row = 0; row < boardRows; row++) {
+    for (int col = 0; col < boardCols; col++) {
+      if (!cell(row, col).opponentShot) {
+        uint16_t& average = model->arrivalTimes[row][col];
+        average = average + (ARRIVAL_NEVER - average) / ARRIVAL_SMOOTHING;
+      }
+    }
+  }
+  arrivalsPending = false;
+}
+
 //debugging function for printing map of opponents hits
 void YuBellPlayer::printProbMap() {
-  for (int row = 0; row < boardSize; row++) {
-		for (int col = 0; col < boardSize; col++) {
-      cout << opponentsHits[row][col] << " ";
+  for (int row = 0; row < boardRows; row++) {
+		for (int col = 0; col < boardCols; col++) {
+      cout << model->opponentsHits[row][col] << " ";
 		}
     cout << endl;
 	}
@@ -114,9 +271,9 @@ void YuBellPlayer::printProbMap() {
 }
 
 void YuBellPlayer::printShipsPlaced() {
-  for (int row = 0; row < boardSize; row++) {
-		for (int col = 0; col < boardSize; col++) {
-      cout << shipsPlaced[row][col] << " ";
+  for (int row = 0; row < boardRows; row++) {
+		for (int col = 0; col < boardCols; col++) {
+      cout << (int)cell(row, col).shipPlaced << " ";
 		}
     cout << endl;
 	}
@@ -133,6 +290,19 @@ void YuBellPlayer::printShipsPlaced() {
  * Message constructor.
  */
 Message YuBellPlayer::getMove() {
+    return getMove(Clock::time_point::max());
+}
+
+/**
+ * @brief Shot choice with a time budget.
+ * @param deadline When the move has to be returned by.
+ *
+ * When we aren't following up a hit and few enough cells are unknown, the
+ * endgame solver picks the shot exactly. Otherwise, ties in the attack map are
+ * broken by how many ship placements pass through each tied cell, counting as
+ * many of the tied cells as the deadline allows.
+ */
+Message YuBellPlayer::getMove(Clock::time_point deadline) {
     vector<int> rowMoves;
     vector<int> colMoves;
 
@@ -166,35 +336,56 @@ Message YuBellPlayer::getMove() {
 
       if (rowMoves.size() == 0) {
         Point hit = hits.back();
-        if (onBoard(hit.row+1, hit.col) && board[hit.row+1][hit.col] == WATER) {
+        if (onBoard(hit.row+1, hit.col) && cell(hit.row+1, hit.col).shot == WATER) {
           rowMoves.push_back(hit.row+1);
           colMoves.push_back(hit.col);
         }
-        if (onBoard(hit.row, hit.col+1) && board[hit.row][hit.col+1] == WATER) {
+        if (onBoard(hit.row, hit.col+1) && cell(hit.row, hit.col+1).shot == WATER) {
           rowMoves.push_back(hit.row);
           colMoves.push_back(hit.col+1);
         }
-        if (onBoard(hit.row-1, hit.col) && board[hit.row-1][hit.col] == WATER) {
+        if (onBoard(hit.row-1, hit.col) && cell(hit.row-1, hit.col).shot == WATER) {
           rowMoves.push_back(hit.row-1);
           colMoves.push_back(hit.col);
         }
-        if (onBoard(hit.row, hit.col-1) && board[hit.row][hit.col-1] == WATER) {
+        if (onBoard(hit.row, hit.col-1) && cell(hit.row, hit.col-1).shot == WATER) {
           rowMoves.push_back(hit.row);
           colMoves.push_back(hit.col-1);
         }
       }
     }
 
+    if (rowMoves.size() == 0 && countUnknownCells() <= endgameThreshold) {
+      int row, col;
+      Bitboard unknown, open;
+      for (int r = 0; r < boardRows; r++) {
+        for (int c = 0; c < boardCols; c++) {
+          if (cell(r, c).shot == WATER) unknown.set(Bitboard::cell(r, c));
+          if (cell(r, c).shot == WATER || cell(r, c).shot == HIT) open.set(Bitboard::cell(r, c));
+        }
+      }
+      if (endgame.solve(boardRows, boardCols, unknown, open, shipsAfloat, deadline, row, col)) {
+        rowMoves.push_back(row);
+        colMoves.push_back(col);
+      }
+    }
+
     if (rowMoves.size() == 0) {
       int max = getAttackMax();
-      for (int r = 0; r < boardSize; r++) {
-          for (int c = 0; c < boardSize; c++) {
-              if (attackMap[r][c] == max && board[r][c] == WATER){
-                rowMoves.push_back(r);
-                colMoves.push_back(c);
+      vector<Point> tied;
+      for (int r = 0; r < boardRows; r++) {
+          for (int c = 0; c < boardCols; c++) {
+              if (cell(r, c).attack == max && cell(r, c).shot == WATER){
+                Point point = {r, c};
+                tied.push_back(point);
               }
           }
       }
+      vector<Point> best = pickByPlacementCount(tied, deadline);
+      for (unsigned int i = 0; i < best.size(); i++) {
+        rowMoves.push_back(best.at(i).row);
+        colMoves.push_back(best.at(i).col);
+      }
     }
 
     int random = rand() % rowMoves.size();
@@ -208,11 +399,11 @@ Point YuBellPlayer::findOpenSpaceRight(int row, int col) {
   if (!onBoard(row, col+1)) {
     return emptyPoint;
   }
-  else if (board[row][col+1] == WATER) {
+  else if (cell(row, col+1).shot == WATER) {
     Point point = {row, col+1};
     return point;
   }
-  else if (board[row][col+1] == HIT) {
+  else if (cell(row, col+1).shot == HIT) {
     return findOpenSpaceRight(row, col+1);
   }
   else {
@@ -224,11 +415,11 @@ Point YuBellPlayer::findOpenSpaceLeft(int row, int col) {
   if (!onBoard(row, col-1)) {
     return emptyPoint;
   }
-  else if (board[row][col-1] == WATER) {
+  else if (cell(row, col-1).shot == WATER) {
     Point point = {row, col-1};
     return point;
   }
-  else if (board[row][col-1] == HIT) {
+  else if (cell(row, col-1).shot == HIT) {
     return findOpenSpaceLeft(row, col-1);
   }
   else {
@@ -240,11 +431,11 @@ Point YuBellPlayer::findOpenSpaceUp(int row, int col) {
   if (!onBoard(row+1, col)) {
     return emptyPoint;
   }
-  else if (board[row+1][col] == WATER) {
+  else if (cell(row+1, col).shot == WATER) {
     Point point = {row+1, col};
     return point;
   }
-  else if (board[row+1][col] == HIT) {
+  else if (cell(row+1, col).shot == HIT) {
     return findOpenSpaceUp(row+1, col);
   }
   else {
@@ -256,11 +447,11 @@ Point YuBellPlayer::findOpenSpaceDown(int row, int col) {
   if (!onBoard(row-1, col)) {
     return emptyPoint;
   }
-  else if (board[row-1][col] == WATER) {
+  else if (cell(row-1, col).shot == WATER) {
     Point point = {row-1, col};
     return point;
   }
-  else if (board[row-1][col] == HIT) {
+  else if (cell(row-1, col).shot == HIT) {
     return findOpenSpaceDown(row-1, col);
   }
   else {
@@ -268,13 +459,79 @@ Point YuBellPlayer::findOpenSpaceDown(int row, int col) {
   }
 }
 
+/**
+ * @brief Narrows tied candidate shots down to those the most remaining ship placements pass through.
+ * If the deadline passes first, the best of the candidates counted so far are returned; all of
+ * them are returned if there is only one, or if the deadline passed before any was counted.
+ */
+vector<Point> YuBellPlayer::pickByPlacementCount(const vector<Point>& candidates, Clock::time_point deadline) {
+  if (candidates.size() < 2) {
+    return candidates;
+  }
+
+  vector<Point> best;
+  int bestCount = -1;
+  for (unsigned int i = 0; i < candidates.size(); i++) {
+    if (Clock::now() >= deadline) {
+      break;
+    }
+    int count = countPlacementsThrough(candidates.at(i).row, candidates.at(i).col);
+    if (count > bestCount) {
+      bestCount = count;
+      best.clear();
+    }
+    if (count == bestCount) {
+      best.push_back(candidates.at(i));
+    }
+  }
+  return best.empty() ? candidates : best;
+}
+
+/**
+ * @brief Counts the placements of this round's remaining ships that cover the given cell
+ * without crossing a miss or a sunk ship.
+ */
+int YuBellPlayer::countPlacementsThrough(int row, int col) {
+  int count = 0;
+  for (unsigned int shipNum = 0; shipNum < shipsAfloat.size(); shipNum++) {
+    int length = shipsAfloat.at(shipNum);
+    //horizontal placements starting anywhere from length-1 cells left of col up to col
+    for (int start = col - length + 1; start <= col; start++) {
+      bool fits = start >= 0 && start + length <= boardCols;
+      for (int c = start; fits && c < start + length; c++) {
+        fits = cell(row, c).shot != MISS && cell(row, c).shot != KILL;
+      }
+      if (fits) count++;
+    }
+    //vertical placements
+    for (int start = row - length + 1; start <= row; start++) {
+      bool fits = start >= 0 && start + length <= boardRows;
+      for (int r = start; fits && r < start + length; r++) {
+        fits = cell(r, col).shot != MISS && cell(r, col).shot != KILL;
+      }
+      if (fits) count++;
+    }
+  }
+  return count;
+}
+
+int YuBellPlayer::countUnknownCells() {
+  int count = 0;
+  for (int r = 0; r < boardRows; r++) {
+    for (int c = 0; c < boardCols; c++) {
+      if (cell(r, c).shot == WATER) count++;
+    }
+  }
+  return count;
+}
+
 int YuBellPlayer::getAttackMax(){
     int max = 0;
     bool first = true;
-    for (int r = 0; r < boardSize; r++) {
-        for (int c = 0; c < boardSize; c++) {
-            if ((attackMap[r][c] > max || first) && board[r][c] == WATER){
-              max = attackMap[r][c];
+    for (int r = 0; r < boardRows; r++) {
+        for (int c = 0; c < boardCols; c++) {
+            if ((cell(r, c).attack > max || first) && cell(r, c).shot == WATER){
+              max = cell(r, c).attack;
               first = false;
             }
         }
@@ -287,24 +544,27 @@ int YuBellPlayer::getAttackMax(){
  * The AI show reinitialize any intra-round data structures.
  */
 void YuBellPlayer::newRound() {
+    foldArrivals();
     this->currentRound++;
     this->numShipsPlaced = 0;
     this->killCount = 0;
-
-    for (int row = 0; row < boardSize; ++row) {
-      for (int col = 0; col < boardSize; ++col) {
-        attackMap[row][col] = 4*attackProbabilities[row][col];
+    this->shipsAfloat.clear();
+    this->opponentShots = 0;
+    this->arrivalsPending = true;
+
+    for (int row = 0; row < boardRows; ++row) {
+      for (int col = 0; col < boardCols; ++col) {
+        CellState& state = cell(row, col);
+        state.attack = params.attackWeight*model->attackProbabilities[row][col];
+        //the opponent shoots here often, and early: the earlier, the worse a spot for a ship
+        int shotScore = params.placementWeight*model->opponentsHits[row][col];
+        double earliness = 1.0 - (double)model->arrivalTimes[row][col] / ARRIVAL_NEVER;
+        state.placementScore = shotScore + (int)(shotScore * params.arrivalWeight * earliness);
+        state.shot = WATER;
+        state.shipPlaced = 0;
+        state.opponentShot = 0;
       }
     }
-
-    for (int row = 0; row < boardSize; ++row) {
-      for (int col = 0; col < boardSize; ++col) {
-        shipPlacementScoring[row][col] = 3*opponentsHits[row][col];
-      }
-    }
-
-    this->initializeBoard();
-    this->initializeShipsPlaced();
 }
 
 /**
@@ -336,47 +596,31 @@ Message YuBellPlayer::placeShip(int length) {
       direction = Horizontal;
     }
 
-    //find possible horizontal positions
-    //if (direction == Horizontal) {
-      for (int row = 0; row < boardSize; ++row) {
-        for (int col = 0; col < boardSize - length; ++col) {
-          //see if a ship starting from this position would not run into any existing ships
-          bool shipFits = true;
-          for (int shipPart = col; shipPart < col + length; ++shipPart) {
-            if (shipsPlaced[row][shipPart] != 0) {
-              shipFits = false;
-            }
-          }
-          //if it wouldn't, score the position and add to possible positions
-          if (shipFits) {
-            Ship ship = {row, col, length, Horizontal, 1.0};
-            ship = scoreShipPlacement(ship);
-            possiblePositions.push_back(ship);
+    //find possible positions that would not run into any existing ships
+    const vector<Placement>& placements = placementTable(boardRows, boardCols, length);
+    for (unsigned int i = 0; i < placements.size(); ++i) {
+      Ship ship = {placements[i].row, placements[i].col, length, (Direction)placements[i].direction, 1.0};
+      bool shipFits = true;
+      if (ship.direction == Horizontal) {
+        for (int shipPart = ship.col; shipPart < ship.col + length; ++shipPart) {
+          if (cell(ship.row, shipPart).shipPlaced != 0) {
+            shipFits = false;
           }
         }
       }
-  //  }
-
-    //find possible vertical positions
-    //if (direction == Vertical) {
-      for (int row = 0; row < boardSize - length; ++row) {
-        for (int col = 0; col < boardSize; ++col) {
-          //see if a ship starting from this position would not run into any existing ships
-          bool shipFits = true;
-          for (int shipPart = row; shipPart < row + length; ++shipPart) {
-            if (shipsPlaced[shipPart][col] != 0) {
-              shipFits = false;
-            }
-          }
-          //if it wouldn't, score the position and add to possible positions
-          if (shipFits) {
-            Ship ship = {row, col, length, Vertical, 1.0};
-            ship = scoreShipPlacement(ship);
-            possiblePositions.push_back(ship);
+      else {
+        for (int shipPart = ship.row; shipPart < ship.row + length; ++shipPart) {
+          if (cell(shipPart, ship.col).shipPlaced != 0) {
+            shipFits = false;
           }
         }
       }
-    //}
+      //if it wouldn't, score the position and add to possible positions
+      if (shipFits) {
+        ship = scoreShipPlacement(ship);
+        possiblePositions.push_back(ship);
+      }
+    }
 
     //print possible positions
     for (vector<Ship>::iterator it = possiblePositions.begin(); it < possiblePositions.end(); it++) {
@@ -395,7 +639,7 @@ Message YuBellPlayer::placeShip(int length) {
     //update map of placed ships
     updatePlacedShips(shipPlacement);
     //for (int shipPart = shipPlacement.col; shipPart < shipPlacement.col + length; ++shipPart) {
-    //  shipsPlaced[shipPlacement.row][shipPart] = 1;
+    //  cell(shipPlacement.row, shipPart).shipPlaced = 1;
     //}
 
     //print map of placed ships
@@ -406,37 +650,69 @@ Message YuBellPlayer::placeShip(int length) {
     //prepare response with chosen ship placement
     // parameters = mesg type (PLACE_SHIP), row, col, a string, direction (Horizontal/Vertical)
     Message response( PLACE_SHIP, shipPlacement.row, shipPlacement.col, shipName, shipPlacement.direction, length );
-    shipLengths.push_back(length);
+    addShipLength(length);
+    shipsAfloat.push_back(length);
     numShipsPlaced++;
 
     if (shipPlacement.direction == Vertical) {
       for (int row = shipPlacement.row; row < shipPlacement.row + length; ++row) {
         if (onBoard(row, shipPlacement.col-1))
-          shipPlacementScoring[row][shipPlacement.col-1] += 1000;
+          cell(row, shipPlacement.col-1).placementScore += params.adjacencyPenalty;
         if (onBoard(row, shipPlacement.col+1))
-          shipPlacementScoring[row][shipPlacement.col+1] += 1000;
+          cell(row, shipPlacement.col+1).placementScore += params.adjacencyPenalty;
       }
       if (onBoard(shipPlacement.row - 1, shipPlacement.col))
-        shipPlacementScoring[shipPlacement.row - 1][shipPlacement.col] += 1000;
+        cell(shipPlacement.row - 1, shipPlacement.col).placementScore += params.adjacencyPenalty;
       if (onBoard(shipPlacement.row + length, shipPlacement.col))
-        shipPlacementScoring[shipPlacement.row + length][shipPlacement.col] += 1000;
+        cell(shipPlacement.row + length, shipPlacement.col).placementScore += params.adjacencyPenalty;
     }
     if (shipPlacement.direction == Horizontal) {
       for (int col = shipPlacement.col; col < shipPlacement.col + length; ++col) {
         if (onBoard(shipPlacement.row-1, col))
-          shipPlacementScoring[shipPlacement.row-1][col] += 1000;
+          cell(shipPlacement.row-1, col).placementScore += params.adjacencyPenalty;
         if (onBoard(shipPlacement.row+1, col))
-          shipPlacementScoring[shipPlacement.row+1][col] += 1000;
+          cell(shipPlacement.row+1, col).placementScore += params.adjacencyPenalty;
       }
       if (onBoard(shipPlacement.row, shipPlacement.col - 1))
-        shipPlacementScoring[shipPlacement.row][shipPlacement.col-1] += 1000;
+        cell(shipPlacement.row, shipPlacement.col-1).placementScore += params.adjacencyPenalty;
       if (onBoard(shipPlacement.row, shipPlacement.col + length))
-        shipPlacementScoring[shipPlacement.row][shipPlacement.col + length] += 1000;
+        cell(shipPlacement.row, shipPlacement.col + length).placementScore += params.adjacencyPenalty;
     }
 
     return response;
 }
 
+/**
+ * @brief Returns every position a ship of the given length can take on an empty rows x cols board:
+ * all horizontal positions row by row, then all vertical ones.
+ * Built the first time any instance asks for it and shared from then on; tables are never
+ * removed, so the reference stays valid.
+ */
+const vector<Placement>& YuBellPlayer::placementTable(int rows, int cols, int length) {
+  int key = (rows * (MAX_BOARD_SIZE + 1) + cols) * (MAX_BOARD_SIZE + 1) + length;
+  lock_guard<mutex> lock(placementTablesLock);
+  map<int, vector<Placement> >::iterator found = placementTables.find(key);
+  if (found != placementTables.end()) {
+    return found->second;
+  }
+
+  vector<Placement>& placements = placementTables[key];
+  placements.reserve(rows * max(0, cols - length) + max(0, rows - length) * cols);
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols - length; ++col) {
+      Placement placement = {(uint8_t)row, (uint8_t)col, (uint8_t)Horizontal};
+      placements.push_back(placement);
+    }
+  }
+  for (int row = 0; row < rows - length; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      Placement placement = {(uint8_t)row, (uint8_t)col, (uint8_t)Vertical};
+      placements.push_back(placement);
+    }
+  }
+  return placements;
+}
+
 /**
  * @brief Returns a Ship with updated placement score based on where opponent has shot
  */
@@ -444,12 +720,12 @@ Ship YuBellPlayer::scoreShipPlacement(Ship ship) {
   int score = 0.0;
   if (ship.direction == Horizontal) {
     for (int shipPart = ship.col; shipPart < ship.col + ship.length; ++shipPart) {
-      score += shipPlacementScoring[ship.row][shipPart];
+      score += cell(ship.row, shipPart).placementScore;
     }
   }
   if (ship.direction == Vertical) {
     for (int shipPart = ship.row; shipPart < ship.row + ship.length; ++shipPart) {
-      score += shipPlacementScoring[shipPart][ship.col];
+      score += cell(shipPart, ship.col).placementScore;
     }
   }
   ship.score = score;
@@ -464,16 +740,18 @@ vector<Ship> YuBellPlayer::getScoreAdjustedPositions(vector<Ship> positions) {
   vector<Ship> rawDoubleScorePositions;
   for (unsigned int i = 0; i < positions.size(); ++i) {
     Ship currentShip = positions.at(i);
-    double adjustedScore = (1.0/(double)currentShip.score) * 10000.0;
+    //a zero weight can still make a score 0; treat it as the best possible score rather than divide by it
+    double adjustedScore = (1.0/max(1.0, currentShip.score)) * 10000.0;
     currentShip.score = adjustedScore;
     rawDoubleScorePositions.push_back(currentShip);
   }
 
-  //find the top 5 scored placements and multiply them to increase their chances of being chosen
+  //find the top scored placements and multiply them to increase their chances of being chosen
   sort(rawDoubleScorePositions.rbegin(), rawDoubleScorePositions.rend());
-  int multiplier = (rawDoubleScorePositions.size() - 5);
+  int top = min(params.topPlacements, (int)rawDoubleScorePositions.size());
+  double multiplier = params.topPlacementBoost * (int)(rawDoubleScorePositions.size() - top);
   //cout << "multiplier: " << multiplier << endl;
-  for (vector<Ship>::iterator it = rawDoubleScorePositions.begin(); it < rawDoubleScorePositions.begin() + 5; ++it) {
+  for (vector<Ship>::iterator it = rawDoubleScorePositions.begin(); it < rawDoubleScorePositions.begin() + top; ++it) {
     it->score *= multiplier;
   }
 
@@ -496,37 +774,58 @@ vector<Ship> YuBellPlayer::getScoreAdjustedPositions(vector<Ship> positions) {
 void YuBellPlayer::updatePlacedShips(Ship ship) {
   if (ship.direction == Horizontal) {
     for (int shipPart = ship.col; shipPart < ship.col + ship.length; ++shipPart) {
-        shipsPlaced[ship.row][shipPart] = 1;
+        cell(ship.row, shipPart).shipPlaced = 1;
     }
   }
   if (ship.direction == Vertical) {
     for (int shipPart = ship.row; shipPart < ship.row + ship.length; ++shipPart) {
-        shipsPlaced[shipPart][ship.col] = 1;
+        cell(shipPart, ship.col).shipPlaced = 1;
     }
   }
 }
 
-void YuBellPlayer::missed(int row, int col){
-    for (int shipNum = 0; shipNum < shipLengths.size(); shipNum++) {
-        for (int i = 1; i < shipLengths.at(shipNum); i++){
-            if(onBoard(row+i))
-                attackMap[row+i][col] -= 1;
-            if(onBoard(row-i))
-                attackMap[row-i][col] -= 1;
-            if(onBoard(col+i))
-                attackMap[row][col+i] -= 1;
-            if(onBoard(col-i))
-                attackMap[row][col-i] -= 1;
-        }
+/*
+ * Keep missReach in step with shipLengthCounts, so missed() doesn't have to walk every ship.
+ */
+void YuBellPlayer::addShipLength(int length) {
+    if (length < 0 || length > MAX_BOARD_SIZE) {
+        return;
+    }
+    shipLengthCounts[length]++;
+    for (int d = 1; d < length && d < MAX_BOARD_SIZE; d++) {
+        missReach[d]++;
     }
 }
 
-bool YuBellPlayer::onBoard(int x){
-    return x >= 0 && x < MAX_BOARD_SIZE;
+void YuBellPlayer::removeShipLength(int length) {
+    if (length < 0 || length > MAX_BOARD_SIZE || shipLengthCounts[length] == 0) {
+        return;
+    }
+    shipLengthCounts[length]--;
+    for (int d = 1; d < length && d < MAX_BOARD_SIZE; d++) {
+        missReach[d]--;
+    }
 }
 
-bool YuBellPlayer::onBoard(int x, int y){
-  return onBoard(x) && onBoard(y);
+/*
+ * A miss makes the cells in line with it less likely, the nearer the more so:
+ * each cell d away loses one point for every ship longer than d.
+ */
+void YuBellPlayer::missed(int row, int col){
+    for (int d = 1; d < MAX_BOARD_SIZE && missReach[d] > 0; d++){
+        if(onBoard(row+d, col))
+            cell(row+d, col).attack -= missReach[d];
+        if(onBoard(row-d, col))
+            cell(row-d, col).attack -= missReach[d];
+        if(onBoard(row, col+d))
+            cell(row, col+d).attack -= missReach[d];
+        if(onBoard(row, col-d))
+            cell(row, col-d).attack -= missReach[d];
+    }
+}
+
+bool YuBellPlayer::onBoard(int row, int col){
+  return row >= 0 && row < boardRows && col >= 0 && col < boardCols;
 }
 
 /**
@@ -534,48 +833,65 @@ bool YuBellPlayer::onBoard(int x, int y){
  * @param msg Message specifying what happened + row/col as appropriate.
  */
 void YuBellPlayer::update(Message msg) {
-  if (msg.getMessageType() != KILL && killCount > 0) {
-    for (int i = 0; i < shipLengths.size(); i++) {
-      if (shipLengths.at(i) == killCount) {
-        shipLengths.erase(shipLengths.begin() + i);
+  handleEvent(msg.getMessageType(), msg.getRow(), msg.getCol());
+}
+
+/**
+ * @brief Same as update(Message), for a whole turn's worth of updates at once.
+ * @param events The updates, oldest first.
+ * @param count How many there are.
+ */
+void YuBellPlayer::update(const PlayerEvent* events, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    handleEvent(events[i].type, events[i].row, events[i].col);
+  }
+}
+
+//applies one update; type is HIT, MISS, KILL, OPPONENT_SHOT, WIN, LOSE or TIE
+void YuBellPlayer::handleEvent(char type, int row, int col) {
+  if (type != KILL && killCount > 0) {
+    removeShipLength(killCount);
+    for (unsigned int i = 0; i < shipsAfloat.size(); i++) {
+      if (shipsAfloat.at(i) == killCount) {
+        shipsAfloat.erase(shipsAfloat.begin() + i);
         break;
       }
     }
     killCount = 0;
   }
-    switch(msg.getMessageType()) {
+    switch(type) {
 	case HIT:
-      board[msg.getRow()][msg.getCol()] = msg.getMessageType();
-      attackProbabilities[msg.getRow()][msg.getCol()] += 1;
+      cell(row, col).shot = type;
+      bumpCounter(model->attackProbabilities, row, col);
       Point hit;
-      hit.row = msg.getRow();
-      hit.col = msg.getCol();
+      hit.row = row;
+      hit.col = col;
       hits.push_back(hit);
       break;
 	case KILL:
-      board[msg.getRow()][msg.getCol()] = msg.getMessageType();
-      missed(msg.getRow(), msg.getCol());
+      cell(row, col).shot = type;
+      missed(row, col);
       for (int i = 0; i < hits.size(); i++) {
         Point hit = hits.at(i);
-        if (hit.row == msg.getRow() && hit.col == msg.getCol()) {
+        if (hit.row == row && hit.col == col) {
           hits.erase(hits.begin() + i);
         }
       }
       killCount++;
       break;
 	case MISS:
-      missed(msg.getRow(), msg.getCol());
-	    board[msg.getRow()][msg.getCol()] = msg.getMessageType();
+      missed(row, col);
+	    cell(row, col).shot = type;
 	    break;
 	case WIN:
-	    break;
 	case LOSE:
-	    break;
 	case TIE:
+      foldArrivals();
 	    break;
 	case OPPONENT_SHOT:
       //update probability information about the opponent's shots
-      this->opponentsHits[msg.getRow()][msg.getCol()]++;
+      bumpCounter(model->opponentsHits, row, col);
+      opponentShotAt(row, col);
 	    break;
     }
 }
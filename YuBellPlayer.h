@@ -9,7 +9,17 @@
 
 using namespace std;
 
+#include <list>
+#include <map>
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+#include <unordered_map>
+#include <mutex>
+
 #include "PlayerV2.h"
+#include "PlayerExtensions.h"
+#include "EndgameSolver.h"
 #include "Message.h"
 #include "defines.h"
 
@@ -24,36 +34,114 @@ class Ship {
 		bool operator<(const Ship &ship) const;
 };
 
+//one position a ship can take on an empty board; shared placement tables hold these
+class Placement {
+	public:
+		uint8_t row;
+		uint8_t col;
+		uint8_t direction; //Horizontal or Vertical
+};
+
 class Point {
 	public:
 		int row;
 		int col;
 };
 
-class YuBellPlayer: public PlayerV2 {
+//what we have learned about one opponent across rounds
+//a counter that would overflow halves every counter in its map instead, which keeps their proportions
+//the maps stay MAX_BOARD_SIZE x MAX_BOARD_SIZE whatever the board in use; only the per-round cells are sized to the board
+class OpponentModel {
+	public:
+		uint16_t opponentsHits[MAX_BOARD_SIZE][MAX_BOARD_SIZE]; //where the opponent has shot
+		uint16_t attackProbabilities[MAX_BOARD_SIZE][MAX_BOARD_SIZE]; //where we have hit the opponent's ships
+		uint16_t arrivalTimes[MAX_BOARD_SIZE][MAX_BOARD_SIZE]; //moving average of how far into a round the opponent first shoots each cell
+};
+
+//tuning constants; the defaults are the values the player was developed with
+class YuBellParams {
+	public:
+		YuBellParams();
+		int attackWeight; //attack map starts at this times the learned hits on the opponent's ships
+		int placementWeight; //placement scores start at this times the learned opponent shots
+		int adjacencyPenalty; //added to the placement score of cells next to a ship we've placed
+		int topPlacements; //how many of the best placements get boosted
+		double topPlacementBoost; //their scores are multiplied by this times the number of other placements
+		int cornerValue; //initial learned counts: corners,
+		int edgeValue; //the rest of the edge,
+		int ringStep; //and this much more for every ring closer to the center
+		double arrivalWeight; //placement scores grow by up to this fraction for cells the opponent shoots early
+};
+
+//what we know about one cell of the board during the current round
+class CellState {
+	public:
+		int32_t attack; //attack map: higher means more likely to hold an opponent's ship
+		int32_t placementScore; //lower means a better spot for one of our ships
+		char shot; //our shots at the opponent: WATER, HIT, MISS or KILL
+		uint8_t shipPlaced; //1 where we have placed a ship this round
+		uint8_t opponentShot; //1 where the opponent has shot this round
+};
+
+class YuBellPlayer: public PlayerV2, public OpponentAware, public DeadlineAware, public ConfigAware, public BatchUpdatable {
     public:
     	YuBellPlayer( int boardSize );
     	~YuBellPlayer();
     	void newRound();
     	Message placeShip(int length);
     	Message getMove();
+    	Message getMove(Clock::time_point deadline);
     	void update(Message msg);
+    	void update(const PlayerEvent* events, size_t count);
+      void setOpponent(const string& opponentName);
+      void setGameConfig(const GameConfig& config);
+      void setEndgameThreshold(int unknownCells); //use the exact endgame solver once this few cells are unknown
+      void setParams(const YuBellParams& params); //forgets the opponent models, which were learned with the old values
 
       //testing and debugging functions
       void printProbMap();
       void printShipsPlaced();
 
+      size_t memoryFootprint() const; //bytes used by this player, including what it owns on the heap
+
     private:
+      YuBellPlayer(const YuBellPlayer&); //not copyable: cells and model point into this object's own storage
+      YuBellPlayer& operator=(const YuBellPlayer&);
 
-      int opponentsHits[MAX_BOARD_SIZE][MAX_BOARD_SIZE]; //where the opponent has shot
-      int shipsPlaced[MAX_BOARD_SIZE][MAX_BOARD_SIZE]; //where we have placed ships this round
-			int shipPlacementScoring[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+      //hot per-move state
+      CellState* cells; //per-round state, boardRows x boardCols, row by row, in a 64-byte aligned buffer we own
+      OpponentModel* model; //the current opponent's model
+      int boardRows; //board dimensions; boardSize x boardSize unless a config says otherwise
+      int boardCols;
+      int killCount;
+	    int numShipsPlaced;
       int currentRound; //how many rounds we have played up to this one
-      void initializeProbMap(int probMap[MAX_BOARD_SIZE][MAX_BOARD_SIZE]); //populate a probability map with intial values
-      void initializeShipsPlaced();
+			int endgameThreshold;
+
+      CellState& cell(int row, int col) { return cells[row * boardCols + col]; }
+      void resizeBoard(int rows, int cols);
+
+      //opponent models, most recently used first; the model for the current opponent is always at the front
+      static const unsigned int MAX_OPPONENT_MODELS = 8;
+      typedef list<pair<string, OpponentModel> > OpponentModelList;
+      OpponentModelList opponentModels;
+      unordered_map<string, OpponentModelList::iterator> opponentModelIndex;
+      void initializeProbMap(uint16_t probMap[MAX_BOARD_SIZE][MAX_BOARD_SIZE]); //populate a probability map with intial values
+      static void bumpCounter(uint16_t counters[MAX_BOARD_SIZE][MAX_BOARD_SIZE], int row, int col);
+
+      int opponentShots; //shots the opponent has taken this round
+      bool arrivalsPending; //cells the opponent never reached this round are not yet in the model
+      void opponentShotAt(int row, int col);
+      void foldArrivals();
+
       Ship scoreShipPlacement(Ship ship);
       vector<Ship> getScoreAdjustedPositions(vector<Ship> positions);
       void updatePlacedShips(Ship ship);
+      //every placement of a ship of each length on each board geometry, built on first use and
+      //shared by all instances; keyed by rows, cols and length together
+      static map<int, vector<Placement> > placementTables;
+      static mutex placementTablesLock;
+      static const vector<Placement>& placementTable(int rows, int cols, int length);
 			vector<Point> hits;
 
 			Point findOpenSpaceRight(int row, int col);
@@ -61,20 +149,21 @@ class YuBellPlayer: public PlayerV2 {
 			Point findOpenSpaceUp(int row, int col);
 			Point findOpenSpaceDown(int row, int col);
 			Point emptyPoint;
-			int killCount;
 
-    	void initializeBoard();
-      int lastRow;
-      int lastCol;
-	    int numShipsPlaced;
-			int attackMap[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
-			int attackProbabilities[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
-			vector<int> shipLengths;
+			int shipLengthCounts[MAX_BOARD_SIZE + 1]; //ships of each length placed and not yet sunk, over every round
+			vector<int> shipsAfloat; //this round's fleet, minus the ships we've sunk
+			int missReach[MAX_BOARD_SIZE]; //missReach[d]: how many of those ships are longer than d
+			void addShipLength(int length);
+			void removeShipLength(int length);
 			void missed(int row, int col);
-			bool onBoard(int x);
-			bool onBoard(int x, int y);
+			bool onBoard(int row, int col);
 			int getAttackMax();
-      char board[MAX_BOARD_SIZE][MAX_BOARD_SIZE];
+			vector<Point> pickByPlacementCount(const vector<Point>& candidates, Clock::time_point deadline);
+			int countPlacementsThrough(int row, int col);
+			int countUnknownCells();
+			EndgameSolver endgame;
+			YuBellParams params;
+			void handleEvent(char type, int row, int col);
 };
 
 #endif
@@ -0,0 +1,158 @@
+/**
+ * @brief Checks for YuBellPlayer on rectangular boards.
+ * @file YuBellPlayerTest.cpp
+ *
+ * AIContest only plays square boards of the size a player was created with,
+ * so the contest never changes a player's geometry; setGameConfig() and the
+ * rectangular board handling are exercised here instead. A small referee
+ * plays whole seeded rounds against the player and checks that its ships and
+ * shots stay on the board, that ships don't overlap and that no cell is shot
+ * twice.
+ *
+ * Run with 'make check'. Prints one line per failed check and exits non-zero
+ * if any failed.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+#include "YuBellPlayer.h"
+
+using namespace std;
+
+// Small enough to always fit: Yu/Bell keeps horizontal ships out of the last
+// column and vertical ones out of the last row
+const int FleetLengths[] = { 2, 3, 3 };
+const int NumShips = sizeof(FleetLengths) / sizeof(FleetLengths[0]);
+const int RoundsPerBoard = 30;
+
+int failures = 0;
+
+void check( bool ok, const string& what ) {
+    if( !ok ) {
+	cout << "FAILED: " << what << endl;
+	failures++;
+    }
+}
+
+/*
+ * Lays out the fleet at random for the player to shoot at: ships[r][c] is the
+ * index of the ship covering the cell, or -1.
+ */
+void layOutFleet( int rows, int cols, vector<vector<int> >& ships ) {
+    ships.assign(rows, vector<int>(cols, -1));
+    for( int ship=0; ship<NumShips; ship++ ) {
+	int length = FleetLengths[ship];
+	for( ;; ) {
+	    bool horizontal = rand() % 2 == 0;
+	    int row = rand() % (horizontal ? rows : rows - length + 1);
+	    int col = rand() % (horizontal ? cols - length + 1 : cols);
+	    bool clear = true;
+	    for( int i=0; i<length; i++ ) {
+		clear = clear && ships[horizontal ? row : row + i][horizontal ? col + i : col] == -1;
+	    }
+	    if( !clear ) continue;
+	    for( int i=0; i<length; i++ ) {
+		ships[horizontal ? row : row + i][horizontal ? col + i : col] = ship;
+	    }
+	    break;
+	}
+    }
+}
+
+/*
+ * Plays one round on a rows x cols board: the player places its fleet, then
+ * shoots until it has sunk ours while we shoot back at random.
+ */
+void playRound( YuBellPlayer& player, int rows, int cols, const string& board ) {
+    player.newRound();
+
+    vector<vector<bool> > placed(rows, vector<bool>(cols, false));
+    for( int ship=0; ship<NumShips; ship++ ) {
+	int length = FleetLengths[ship];
+	Message placement = player.placeShip(length);
+	bool horizontal = placement.getDirection() == Horizontal;
+	int endRow = placement.getRow() + (horizontal ? 1 : length);
+	int endCol = placement.getCol() + (horizontal ? length : 1);
+	bool onBoard = placement.getRow() >= 0 && placement.getCol() >= 0 && endRow <= rows && endCol <= cols;
+	check(onBoard && placement.getLength() == length, board + ": ship placed on the board");
+	if( !onBoard ) return;
+	for( int r=placement.getRow(); r<endRow; r++ ) {
+	    for( int c=placement.getCol(); c<endCol; c++ ) {
+		check(!placed[r][c], board + ": ships don't overlap");
+		placed[r][c] = true;
+	    }
+	}
+    }
+
+    vector<vector<int> > ships;
+    layOutFleet(rows, cols, ships);
+    vector<int> left(FleetLengths, FleetLengths + NumShips);
+    vector<vector<bool> > shot(rows, vector<bool>(cols, false));
+    int afloat = NumShips;
+    for( int shots=0; afloat>0; shots++ ) {
+	if( shots == rows * cols ) {
+	    check(false, board + ": round ends within one shot per cell");
+	    return;
+	}
+	Message move = player.getMove();
+	int row = move.getRow(), col = move.getCol();
+	if( row < 0 || row >= rows || col < 0 || col >= cols ) {
+	    check(false, board + ": shot on the board");
+	    return;
+	}
+	check(!shot[row][col], board + ": no cell shot twice");
+	shot[row][col] = true;
+
+	int ship = ships[row][col];
+	if( ship < 0 ) {
+	    player.update(Message(MISS, row, col, "", None, 0));
+	} else if( --left[ship] > 0 ) {
+	    player.update(Message(HIT, row, col, "", None, 0));
+	} else {
+	    // A sunk ship is reported one KILL per cell, the cell just shot first
+	    player.update(Message(KILL, row, col, "", None, 0));
+	    for( int r=0; r<rows; r++ ) {
+		for( int c=0; c<cols; c++ ) {
+		    if( ships[r][c] == ship && (r != row || c != col) ) {
+			player.update(Message(KILL, r, c, "", None, 0));
+		    }
+		}
+	    }
+	    afloat--;
+	}
+	player.update(Message(OPPONENT_SHOT, rand() % rows, rand() % cols, "", None, 0));
+    }
+    player.update(Message(WIN, -1, -1, "", None, 0));
+}
+
+/*
+ * A player created for the largest board and then configured down to rows x cols.
+ */
+void testBoard( int rows, int cols ) {
+    ostringstream board;
+    board << rows << "x" << cols;
+    srand(rows * MAX_BOARD_SIZE + cols);
+
+    YuBellPlayer player(MAX_BOARD_SIZE);
+    GameConfig config = { rows, cols };
+    player.setGameConfig(config);
+    player.setOpponent("Referee");
+    for( int round=0; round<RoundsPerBoard; round++ ) {
+	playRound(player, rows, cols, board.str());
+    }
+}
+
+int main() {
+    testBoard(4, 7);
+    testBoard(7, 4);
+    testBoard(3, 10);
+    testBoard(6, 6);
+    if( failures == 0 ) {
+	cout << "YuBellPlayer: all checks passed" << endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,265 @@
+/**
+ * @brief Seeded macro-benchmark for Yu/Bell Player, with a regression baseline.
+ * @file bench.cpp
+ *
+ * Plays a fixed suite: Yu/Bell Player against Dumb Player and the two prebuilt
+ * gamblers on several board sizes, every game seeded, silently and in one
+ * process. Both players are wrapped in TimedPlayers, as in a contest, so the
+ * batched update path is measured too. For each (board, opponent) pair it
+ * measures games per second, win rate and average shots per game. Quality is
+ * deterministic for a given build; speed is the best of several repeats of the
+ * whole suite.
+ *
+ * The results are compared with a baseline file. The run fails (exit status 1)
+ * when the suite's overall games/sec drops more than --speed-tolerance below
+ * the baseline, or when any pair's win rate drops more than --quality-tolerance
+ * or its shots/game rises more than that fraction. Without a baseline file,
+ * or with --update-baseline, the results are written as the new baseline.
+ *
+ * Baseline file: '#' comments, then one line per pair and a final "total" line:
+ *   <boardSize> <opponent> <gamesPerSecond> <winRate> <shotsPerGame>
+ * with 'all' for the board size and opponent on the total line.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include "AIContest.h"
+#include "PlayerV2.h"
+#include "PlayerExtensions.h"
+#include "TimedPlayer.h"
+#include "YuBellPlayer.h"
+#include "DumbPlayerV2.h"
+#include "OrigGamblerPlayerV2.h"
+#include "LearningGambler2.h"
+
+using namespace std;
+
+const unsigned int BenchSeed = 20170410;
+const int BenchBoardSizes[] = { 6, 8, 10 };
+const int NumBenchBoardSizes = sizeof(BenchBoardSizes) / sizeof(BenchBoardSizes[0]);
+const char* OpponentNames[] = { "dumb", "orig-gambler", "learning-gambler" };
+const int NumOpponents = sizeof(OpponentNames) / sizeof(OpponentNames[0]);
+
+struct BenchResult {
+    string board;		// Board size, or "all"
+    string opponent;		// Opponent name, or "all"
+    double gamesPerSecond;
+    double winRate;
+    double shotsPerGame;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+BenchResult playPair( int boardSize, int opponentId, int games, size_t& playerBytes );
+bool readBaseline( const string& path, vector<BenchResult>& baseline );
+bool writeBaseline( const string& path, const vector<BenchResult>& results );
+void printResult( const BenchResult& result );
+
+/*
+ * Plays one (board, opponent) pair of the suite. Game g of the pair is seeded
+ * with a value that depends only on the pair and g.
+ */
+BenchResult playPair( int boardSize, int opponentId, int games, size_t& playerBytes ) {
+    YuBellPlayer* yuBell = new YuBellPlayer( boardSize );
+    PlayerV2* opponent;
+    switch( opponentId ) {
+	default:
+	case 0: opponent = new DumbPlayerV2( boardSize ); break;
+	case 1: opponent = new OrigGamblerPlayerV2( boardSize ); break;
+	case 2: opponent = new LearningGambler2( boardSize ); break;
+    }
+    yuBell->setOpponent(OpponentNames[opponentId]);
+    TimedPlayer* timedYuBell = new TimedPlayer(yuBell, boardSize);
+    TimedPlayer* timedOpponent = new TimedPlayer(opponent, boardSize);
+
+    int wins = 0;
+    long shots = 0;
+    Clock::time_point start = Clock::now();
+    for( int game=0; game<games; game++ ) {
+	bool yuBellWon = false, opponentWon = false;
+	int moves = 0;
+	srand(BenchSeed + (boardSize * NumOpponents + opponentId) * games + game);
+	timedYuBell->newRound();
+	timedOpponent->newRound();
+	AIContest contest( timedYuBell, "Yu/Bell Player", timedOpponent, OpponentNames[opponentId], boardSize, true );
+	contest.play( 0, moves, yuBellWon, opponentWon );
+	shots += moves;
+	if( yuBellWon && !opponentWon ) wins++;
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    delete timedYuBell;
+    delete timedOpponent;
+
+    playerBytes = max(playerBytes, yuBell->memoryFootprint());
+    delete yuBell;
+    delete opponent;
+
+    ostringstream board;
+    board << boardSize;
+    BenchResult result = { board.str(), OpponentNames[opponentId], games / max(seconds, 1e-9),
+			   (double)wins / games, (double)shots / games };
+    return result;
+}
+
+bool readBaseline( const string& path, vector<BenchResult>& baseline ) {
+    ifstream in(path.c_str());
+    if( !in ) {
+	return false;
+    }
+    string line;
+    while( getline(in, line) ) {
+	if( line.empty() || line[0] == '#' ) continue;
+	istringstream fields(line);
+	BenchResult result;
+	if( fields >> result.board >> result.opponent >> result.gamesPerSecond
+	    >> result.winRate >> result.shotsPerGame ) {
+	    baseline.push_back(result);
+	}
+    }
+    return true;
+}
+
+bool writeBaseline( const string& path, const vector<BenchResult>& results ) {
+    ofstream out(path.c_str(), ios::out | ios::trunc);
+    out << "# bench baseline: <boardSize> <opponent> <gamesPerSecond> <winRate> <shotsPerGame>" << endl;
+    out << setprecision(9);
+    for( size_t i=0; i<results.size(); i++ ) {
+	out << results[i].board << " " << results[i].opponent << " " << results[i].gamesPerSecond
+	    << " " << results[i].winRate << " " << results[i].shotsPerGame << endl;
+    }
+    return (bool)out;
+}
+
+void printResult( const BenchResult& result ) {
+    cout << "board " << setw(3) << result.board << "  vs " << setw(16) << left << result.opponent << right
+	 << fixed << setprecision(1) << setw(9) << result.gamesPerSecond << " games/sec"
+	 << setprecision(2) << "  win " << setw(6) << 100 * result.winRate << "%"
+	 << "  shots/game " << setprecision(4) << result.shotsPerGame << endl;
+    cout.unsetf(ios::floatfield);
+}
+
+/*
+ * Options:
+ *   --games=N                 games per (board, opponent) pair (default 500)
+ *   --repeat=N                times to play the suite; speed is the best run (default 3)
+ *   --baseline=FILE           baseline to compare with (default bench_baseline.txt)
+ *   --update-baseline         write this run's results as the new baseline
+ *   --speed-tolerance=F       allowed fractional drop in games/sec (default 0.10)
+ *   --quality-tolerance=F     allowed drop in win rate, and fractional rise in
+ *                             shots/game, per pair (default 0.02)
+ */
+int main( int argc, char* argv[] ) {
+    int games = 500, repeats = 3;
+    string baselinePath = "bench_baseline.txt";
+    bool updateBaseline = false;
+    double speedTolerance = 0.10, qualityTolerance = 0.02;
+    for( int i=1; i<argc; i++ ) {
+	if( strncmp(argv[i], "--games=", 8) == 0 ) {
+	    games = atoi(argv[i] + 8);
+	} else if( strncmp(argv[i], "--repeat=", 9) == 0 ) {
+	    repeats = atoi(argv[i] + 9);
+	} else if( strncmp(argv[i], "--baseline=", 11) == 0 ) {
+	    baselinePath = argv[i] + 11;
+	} else if( strcmp(argv[i], "--update-baseline") == 0 ) {
+	    updateBaseline = true;
+	} else if( strncmp(argv[i], "--speed-tolerance=", 18) == 0 ) {
+	    speedTolerance = atof(argv[i] + 18);
+	} else if( strncmp(argv[i], "--quality-tolerance=", 20) == 0 ) {
+	    qualityTolerance = atof(argv[i] + 20);
+	} else {
+	    cerr << "Unknown option: " << argv[i] << endl;
+	    return 1;
+	}
+    }
+    if( games < 1 || repeats < 1 ) {
+	cerr << "Option out of range." << endl;
+	return 1;
+    }
+
+    // Quality comes out the same on every repeat; keep the fastest time for each pair
+    vector<BenchResult> results;
+    size_t playerBytes[NumBenchBoardSizes] = { 0 };
+    for( int repeat=0; repeat<repeats; repeat++ ) {
+	int pair = 0;
+	for( int b=0; b<NumBenchBoardSizes; b++ ) {
+	    for( int opponentId=0; opponentId<NumOpponents; opponentId++, pair++ ) {
+		BenchResult result = playPair(BenchBoardSizes[b], opponentId, games, playerBytes[b]);
+		if( repeat == 0 ) {
+		    results.push_back(result);
+		} else {
+		    results[pair].gamesPerSecond = max(results[pair].gamesPerSecond, result.gamesPerSecond);
+		}
+	    }
+	}
+    }
+
+    BenchResult total = { "all", "all", 0, 0, 0 };
+    double totalSeconds = 0;
+    for( size_t i=0; i<results.size(); i++ ) {
+	totalSeconds += games / results[i].gamesPerSecond;
+	total.winRate += results[i].winRate / results.size();
+	total.shotsPerGame += results[i].shotsPerGame / results.size();
+    }
+    total.gamesPerSecond = games * results.size() / totalSeconds;
+    results.push_back(total);
+
+    for( size_t i=0; i<results.size(); i++ ) {
+	printResult(results[i]);
+    }
+    for( int b=0; b<NumBenchBoardSizes; b++ ) {
+	cout << "board " << setw(3) << BenchBoardSizes[b] << "  Yu/Bell Player memory: "
+	     << playerBytes[b] << " bytes" << endl;
+    }
+
+    vector<BenchResult> baseline;
+    if( updateBaseline || !readBaseline(baselinePath, baseline) ) {
+	if( !writeBaseline(baselinePath, results) ) {
+	    cerr << "Could not write baseline " << baselinePath << endl;
+	    return 1;
+	}
+	cout << "Baseline written to " << baselinePath << endl;
+	return 0;
+    }
+
+    bool regressed = false;
+    for( size_t i=0; i<results.size(); i++ ) {
+	const BenchResult* base = NULL;
+	for( size_t j=0; j<baseline.size(); j++ ) {
+	    if( baseline[j].board == results[i].board && baseline[j].opponent == results[i].opponent ) {
+		base = &baseline[j];
+	    }
+	}
+	if( base == NULL ) {
+	    continue;
+	}
+	string pair = "board " + results[i].board + " vs " + results[i].opponent;
+	// Per-pair times are too short to judge speed by; only the whole suite's counts
+	if( results[i].board == "all"
+	    && results[i].gamesPerSecond < base->gamesPerSecond * (1 - speedTolerance) ) {
+	    cout << "REGRESSION " << pair << ": " << results[i].gamesPerSecond << " games/sec, baseline "
+		 << base->gamesPerSecond << endl;
+	    regressed = true;
+	}
+	if( results[i].winRate < base->winRate - qualityTolerance ) {
+	    cout << "REGRESSION " << pair << ": win rate " << results[i].winRate << ", baseline "
+		 << base->winRate << endl;
+	    regressed = true;
+	}
+	if( results[i].shotsPerGame > base->shotsPerGame * (1 + qualityTolerance) ) {
+	    cout << "REGRESSION " << pair << ": " << results[i].shotsPerGame << " shots/game, baseline "
+		 << base->shotsPerGame << endl;
+	    regressed = true;
+	}
+    }
+    cout << (regressed ? "Benchmark regressed against " : "No regressions against ") << baselinePath << endl;
+    return regressed ? 1 : 0;
+}
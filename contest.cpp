@@ -9,7 +9,10 @@
 
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <unistd.h>
 
 // Next 2 to access and setup the random number generator.
@@ -21,6 +24,11 @@
 #include "AIContest.h"
 #include "PlayerV2.h"
 #include "conio.h"
+#include "GameConfig.h"
+#include "PlayerExtensions.h"
+#include "ResultsSink.h"
+#include "ShardRunner.h"
+#include "TimedPlayer.h"
 
 // Include your player here
 #include "TheAdmiral.h"
@@ -33,13 +41,24 @@
 
 
 PlayerV2* getPlayer( int playerId, int boardSize );
+PlayerV2* getPooledPlayer( int playerId );
+void releasePlayerPool();
+void introduce( PlayerV2* player, const string& opponentName );
 void playMatch( int player1Id, int player2Id, bool showMoves );
+void reportMatch( int player1Id, int player2Id, const int matchWins[2], int player1Ties, int player2Ties );
+void playShardedTournament();
+ShardResult playShard( const GameShard& shard );
+string runShardJob( const string& line );
+int runShardFile( const string& path );
 int comparePlayers (const void * a, const void * b);
+bool parseOptions( int argc, char* argv[] );
+int runTraining();
 
 using namespace std;
 using namespace conio;
 
 float secondsPerMove = 1;
+double moveBudget = 0;		// --move-budget: seconds a player may think per move, 0 = unlimited
 int boardSize;	// BoardSize
 int totalGames = 0;
 int totalCountedMoves = 0;
@@ -48,9 +67,25 @@ const int NumPlayers = 2;
 int wins[NumPlayers][NumPlayers];
 int playerIds[NumPlayers];
 int lives[NumPlayers];
+PlayerV2* playerPool[NumPlayers];	// Reused across matches; created on first use
 int winCount[NumPlayers];
 int statsShotsTaken[NumPlayers];
 int statsGamesCounted[NumPlayers];
+int matchNumber = 0;		// Matches played so far, used to number results records
+unsigned int baseSeed;		// Per-game seeds are derived from this
+ResultsSink results;		// Machine-readable output, if requested with --results
+bool trainingRun = false;	// --train: play the fixed profiling workload and exit
+int workers = 1;		// --workers: processes to split the tournament across
+string shardFile;		// --shard-file: run the shards listed in this file and exit
+GameConfig gameConfig;		// --config: board geometry
+bool haveConfig = false;
+
+// The --train workload. It is what the contest-pgo build profiles, so keep it
+// representative: several board sizes and every opponent we can link against.
+const unsigned int TrainingSeed = 20170410;
+const int TrainingGames = 400;		// Games per pairing and board size
+const int TrainingBoardSizes[] = { 4, 6, 8, 10 };
+const int NumTrainingOpponents = 4;
 string playerNames[NumPlayers] = {
     "Dumb Player",
   //   "Orig Gambler",
@@ -60,9 +95,20 @@ string playerNames[NumPlayers] = {
 };
 
 
-int main() {
+int main( int argc, char* argv[] ) {
     //bool silent = false;
 
+    baseSeed = time(NULL);
+    if( !parseOptions(argc, argv) ) {
+	return 1;
+    }
+    if( trainingRun ) {
+	return runTraining();
+    }
+    if( !shardFile.empty() ) {
+	return runShardFile(shardFile);
+    }
+
     // Adjust based on the number of players!
     // Initialize various win statistics
     for(int i=0; i<NumPlayers; i++) {
@@ -71,23 +117,31 @@ int main() {
 	winCount[i] = 0;
 	lives[i] = NumPlayers;
 	playerIds[i] = i;
+	playerPool[i] = NULL;
 	for(int j=0; j<NumPlayers; j++) {
 	    wins[i][j] = 0;
     	}
     }
 
     // Seed (setup) the random number generator.
-    // This only needs to happen once per program run.
-    srand(time(NULL));
+    // This only needs to happen once per program run; playMatch() reseeds
+    // before every game so individual games can be reproduced.
+    srand(baseSeed);
 
     // Now to get the board size.
     cout << "Welcome to the AI Bot contest." << endl << endl;
-    cout << "What size board would you like? [Anything other than numbers 3-10 exits.] ";
-    cin >> boardSize;
-    // If have invalid board size input (non-number, or 0-2, or > 10).
-    if ( !cin || boardSize < 3 || boardSize > 10 ) {
-	cout << "Exiting" << endl;
-	return 1;
+    if( haveConfig ) {
+	boardSize = gameConfig.rows;
+	cout << "Board size " << boardSize << " (from the config file)." << endl;
+    }
+    else {
+	cout << "What size board would you like? [Anything other than numbers 3-10 exits.] ";
+	cin >> boardSize;
+	// If have invalid board size input (non-number, or 0-2, or > 10).
+	if ( !cin || boardSize < 3 || boardSize > 10 ) {
+	    cout << "Exiting" << endl;
+	    return 1;
+	}
     }
 
     // Find out how many times to test the AI.
@@ -111,17 +165,23 @@ int main() {
 	++offset;
     }
     */
-    for( int player1Id=0; player1Id<NumPlayers; player1Id++ ) {
-	for( int player2Id=player1Id+1; player2Id<NumPlayers; player2Id++ ) {
+    if( workers > 1 ) {
+	playShardedTournament();
+    }
+    else {
+	for( int player1Id=0; player1Id<NumPlayers; player1Id++ ) {
+	    for( int player2Id=player1Id+1; player2Id<NumPlayers; player2Id++ ) {
 
-	    // Don't play anybody who has been eliminated
-	    if(lives[player1Id] == 0 || lives[player2Id] == 0) continue;
+		// Don't play anybody who has been eliminated
+		if(lives[player1Id] == 0 || lives[player2Id] == 0) continue;
 
-	    playMatch(player1Id, player2Id, true);
-	    usleep(2000000);	// Pause 2 seconds to let viewers see stats
+		playMatch(player1Id, player2Id, true);
+		usleep(2000000);	// Pause 2 seconds to let viewers see stats
+	    }
 	}
     }
     cout << endl << endl;
+    releasePlayerPool();
 
     // Add up the total wins per player
     for( int i=0; i<NumPlayers; i++ ) {
@@ -139,6 +199,7 @@ int main() {
 
     int tiesInARow = 0;
     for( int i=0; i<NumPlayers; ++i ) {
+	bool tied = false;
 	// If one of two or more that are tied for first place, switch on BOLD
 	if( i!=0 && lives[playerIds[i]] == lives[playerIds[0]] && winCount[playerIds[i]] == winCount[playerIds[0]]) {
 	    cout << setTextStyle( BOLD );
@@ -154,16 +215,147 @@ int main() {
 	     << ", Wins=" << winCount[playerIds[i]] << ")";
 	if( tiesInARow!=0 && (i<NumPlayers-1 && lives[playerIds[1]] == lives[playerIds[1+1]] && winCount[playerIds[i]] == winCount[playerIds[i+1]] )) {
 	    cout << " -- tied ";
+	    tied = true;
 	}
 	else if( tiesInARow > 0 || (i<NumPlayers-1 && lives[playerIds[i]] == lives[playerIds[i-1]] && winCount[playerIds[i]] == winCount[playerIds[i-1]] )) {
 	    cout << " -- tied ";
+	    tied = true;
 	}
 	cout << resetAll () << endl;
+
+	StandingRecord standing = { i+1-tiesInARow, playerNames[playerIds[i]], lives[playerIds[i]],
+				    winCount[playerIds[i]], tied };
+	results.write(standing);
     }
+    results.close();
 
     return 0;
 }
 
+/*
+ * Plays the fixed --train workload: Yu/Bell Player against each training
+ * opponent on each training board size, silently and without pauses. The
+ * seed is fixed so that every profile is collected from the same games.
+ * Players are wrapped in TimedPlayers as in a real contest, so the profile
+ * covers the batched update path too.
+ */
+int runTraining() {
+    const int numBoardSizes = sizeof(TrainingBoardSizes) / sizeof(TrainingBoardSizes[0]);
+    unsigned int seed = TrainingSeed;
+
+    for( int sizeIndex=0; sizeIndex<numBoardSizes; sizeIndex++ ) {
+	int trainingBoardSize = TrainingBoardSizes[sizeIndex];
+	int shotsTaken = 0, gamesWon = 0;
+	size_t playerBytes = 0;
+
+	for( int opponentId=0; opponentId<NumTrainingOpponents; opponentId++ ) {
+	    PlayerV2 *player, *opponent;
+	    player = new YuBellPlayer( trainingBoardSize );
+	    switch( opponentId ) {
+		default:
+		case 0: opponent = new DumbPlayerV2( trainingBoardSize ); break;
+		case 1: opponent = new OrigGamblerPlayerV2( trainingBoardSize ); break;
+		case 2: opponent = new LearningGambler2( trainingBoardSize ); break;
+		case 3: opponent = new YuBellPlayer( trainingBoardSize ); break;
+	    }
+	    introduce( player, "Training opponent" );
+	    introduce( opponent, "Yu/Bell Player" );
+	    TimedPlayer* timedPlayer = new TimedPlayer(player, trainingBoardSize);
+	    TimedPlayer* timedOpponent = new TimedPlayer(opponent, trainingBoardSize);
+
+	    for( int count=0; count<TrainingGames; count++ ) {
+		bool playerWon = false, opponentWon = false;
+		int moves = 0;
+		srand(seed++);
+		timedPlayer->newRound();
+		timedOpponent->newRound();
+		AIContest game( timedPlayer, "Yu/Bell Player", timedOpponent, "Training opponent",
+				trainingBoardSize, true );
+		game.play( 0, moves, playerWon, opponentWon );
+		shotsTaken += moves;
+		if( playerWon && !opponentWon ) gamesWon++;
+	    }
+	    delete timedPlayer;
+	    delete timedOpponent;
+	    playerBytes = max( playerBytes, ((YuBellPlayer*)player)->memoryFootprint() );
+	    delete player;
+	    delete opponent;
+	}
+
+	int gamesPlayed = TrainingGames * NumTrainingOpponents;
+	cout << "Training board " << trainingBoardSize << ": " << gamesPlayed << " games, won "
+	     << gamesWon << ", avg. shots/game = " << (float)shotsTaken/(float)gamesPlayed
+	     << ", player memory = " << playerBytes << " bytes" << endl;
+    }
+    return 0;
+}
+
+/*
+ * Handles the optional command line flags:
+ *   --results=FILE           write machine-readable results to FILE
+ *   --results-format=csv|json  (default: csv if FILE ends in .csv, else JSON lines)
+ *   --seed=N                 base random seed (default: current time)
+ *   --move-budget=SECONDS    time each player may spend choosing a move (default: unlimited)
+ *   --train                  play the fixed profiling workload instead of a contest
+ *   --workers=N              split the games across N worker processes
+ *   --shard-file=FILE        play the shards listed in FILE, print their results and exit
+ *   --config=FILE            board size from a file (see GameConfig.h) instead of asking
+ * Without --train the interactive questions are still asked as before.
+ */
+bool parseOptions( int argc, char* argv[] ) {
+    string resultsPath, resultsFormat;
+    for( int i=1; i<argc; i++ ) {
+	if( strncmp(argv[i], "--results=", 10) == 0 ) {
+	    resultsPath = argv[i] + 10;
+	} else if( strncmp(argv[i], "--results-format=", 17) == 0 ) {
+	    resultsFormat = argv[i] + 17;
+	} else if( strncmp(argv[i], "--seed=", 7) == 0 ) {
+	    baseSeed = strtoul(argv[i] + 7, NULL, 10);
+	} else if( strncmp(argv[i], "--move-budget=", 14) == 0 ) {
+	    moveBudget = atof(argv[i] + 14);
+	} else if( strcmp(argv[i], "--train") == 0 ) {
+	    trainingRun = true;
+	} else if( strncmp(argv[i], "--workers=", 10) == 0 ) {
+	    workers = atoi(argv[i] + 10);
+	} else if( strncmp(argv[i], "--shard-file=", 13) == 0 ) {
+	    shardFile = argv[i] + 13;
+	} else if( strncmp(argv[i], "--config=", 9) == 0 ) {
+	    string error;
+	    if( !loadGameConfig(argv[i] + 9, gameConfig, error) ) {
+		cerr << "Bad config: " << error << endl;
+		return false;
+	    }
+	    // Players can handle any geometry, but AIContest and BoardV3 only play square boards
+	    if( gameConfig.rows != gameConfig.cols ) {
+		cerr << "Bad config: the contest engine only plays square boards (rows must equal cols)" << endl;
+		return false;
+	    }
+	    haveConfig = true;
+	} else {
+	    cerr << "Unknown option " << argv[i] << endl
+		 << "Usage: " << argv[0] << " [--results=FILE] [--results-format=csv|json] [--seed=N]\n\t[--move-budget=SECONDS] [--train] [--workers=N] [--shard-file=FILE]\n\t[--config=FILE]" << endl;
+	    return false;
+	}
+    }
+
+    if( resultsPath.empty() ) {
+	return true;
+    }
+    if( resultsFormat.empty() ) {
+	bool csvName = resultsPath.size() >= 4 && resultsPath.compare(resultsPath.size()-4, 4, ".csv") == 0;
+	resultsFormat = csvName ? "csv" : "json";
+    }
+    if( resultsFormat != "csv" && resultsFormat != "json" ) {
+	cerr << "Unknown results format " << resultsFormat << " (use csv or json)" << endl;
+	return false;
+    }
+    if( !results.open(resultsPath, resultsFormat == "csv" ? CSV_RESULTS : JSON_RESULTS) ) {
+	cerr << "Could not open " << resultsPath << " for writing" << endl;
+	return false;
+    }
+    return true;
+}
+
 void playMatch( int player1Id, int player2Id, bool showMoves ) {
     PlayerV2 *player1, *player2;
     AIContest *game;
@@ -171,29 +363,47 @@ void playMatch( int player1Id, int player2Id, bool showMoves ) {
     bool player1Won=false, player2Won=false;
     int player1Ties=0, player2Ties=0;
 
-    player1 = getPlayer(player1Id, boardSize);
-    player2 = getPlayer(player2Id, boardSize);
+    player1 = getPooledPlayer(player1Id);
+    player2 = getPooledPlayer(player2Id);
+    introduce( player1, playerNames[player2Id] );
+    introduce( player2, playerNames[player1Id] );
+    TimedPlayer timed1(player1, boardSize), timed2(player2, boardSize);
+    timed1.setMoveBudget(moveBudget);
+    timed2.setMoveBudget(moveBudget);
+    matchNumber++;
 
     bool silent = true;
     for( int count=0; count<totalGames; count++ ) {
 	player1Won = false; player2Won = false;
-	player1->newRound();
-	player2->newRound();
+	unsigned int gameSeed = baseSeed + (unsigned int)((matchNumber-1) * totalGames + count);
+	srand(gameSeed);
+	timed1.resetClock();
+	timed2.resetClock();
+	timed1.newRound();
+	timed2.newRound();
 
 	if( count==0 ) {
 	    silent = false;
-	    game = new AIContest( player1, playerNames[player1Id],
-				  player2, playerNames[player2Id],
+	    game = new AIContest( &timed1, playerNames[player1Id],
+				  &timed2, playerNames[player2Id],
 				  boardSize, silent );
 	    game->play( secondsPerMove, totalCountedMoves, player1Won, player2Won );
 	}
 	else {
 	    silent = true;
-	    game = new AIContest( player1, playerNames[player1Id],
-				  player2, playerNames[player2Id],
+	    game = new AIContest( &timed1, playerNames[player1Id],
+				  &timed2, playerNames[player2Id],
 		      boardSize, silent );
 	    game->play( 0, totalCountedMoves, player1Won, player2Won );
 	}
+	if( results.isOpen() ) {
+	    string winner = "tie";
+	    if( player1Won && !player2Won ) winner = playerNames[player1Id];
+	    if( player2Won && !player1Won ) winner = playerNames[player2Id];
+	    GameRecord record = { matchNumber, count+1, playerNames[player1Id], playerNames[player2Id],
+				  winner, totalCountedMoves, timed1.getSeconds(), timed2.getSeconds(), gameSeed };
+	    results.write(record);
+	}
 	if((player1Won && player2Won) || !(player1Won || player2Won)) {
 	    player1Ties++;
 	    player2Ties++;
@@ -214,9 +424,15 @@ void playMatch( int player1Id, int player2Id, bool showMoves ) {
 	}
 	delete game;
     }
-    delete player1;
-    delete player2;
 
+    reportMatch( player1Id, player2Id, matchWins, player1Ties, player2Ties );
+}
+
+/*
+ * Prints a finished match's summary, takes away lives and writes the match record.
+ * wins[][] and the shot statistics must already include the match's games.
+ */
+void reportMatch( int player1Id, int player2Id, const int matchWins[2], int player1Ties, int player2Ties ) {
     cout << endl << "********************" << endl;
     cout << playerNames[player1Id] << ": " << setTextStyle( NEGATIVE_IMAGE ) << "wins=" << matchWins[0] << resetAll()
 	 << " losses=" << totalGames-matchWins[0]-player1Ties
@@ -259,6 +475,15 @@ void playMatch( int player1Id, int player2Id, bool showMoves ) {
 	cout << playerNames[player1Id] << " Lives left: " << lives[player1Id] << endl;
     }
     cout << resetAll() << "********************" << endl;
+
+    MatchRecord record = { matchNumber, playerNames[player1Id], playerNames[player2Id],
+			   matchWins[0], matchWins[1], player1Ties,
+			   (statsGamesCounted[player1Id]==0 ? 0.0 :
+			    (double)statsShotsTaken[player1Id]/(double)statsGamesCounted[player1Id]),
+			   (statsGamesCounted[player2Id]==0 ? 0.0 :
+			    (double)statsShotsTaken[player2Id]/(double)statsGamesCounted[player2Id]),
+			   lives[player1Id], lives[player2Id] };
+    results.write(record);
 }
 
 int comparePlayers (const void * a, const void * b) {
@@ -273,6 +498,191 @@ int comparePlayers (const void * a, const void * b) {
     }
 }
 
+/*
+ * Plays the whole round robin in worker processes. Every match is cut into
+ * one shard per worker; the workers' results are then merged back into
+ * wins[][] and the shot statistics in match order, and each match is reported
+ * as playMatch() would. Nobody can run out of lives before their last match
+ * (everyone starts with NumPlayers lives and plays NumPlayers-1 matches), so
+ * planning every match up front gives the same pairings as the serial loop.
+ * Game seeds and the move budget are the same as in a serial run, but each
+ * shard starts from freshly constructed players, so learning players only
+ * learn within a shard. Shards only send back totals, so there are no
+ * per-game results records.
+ */
+void playShardedTournament() {
+    vector<string> jobs;
+    vector<int> jobMatch;
+    int gamesPerShard = (totalGames + workers - 1) / workers;
+    int match = 0;
+    for( int player1Id=0; player1Id<NumPlayers; player1Id++ ) {
+	for( int player2Id=player1Id+1; player2Id<NumPlayers; player2Id++ ) {
+	    match++;
+	    for( int first=0; first<totalGames; first+=gamesPerShard ) {
+		GameShard shard = { match, player1Id, player2Id, boardSize, first,
+				    min(first + gamesPerShard, totalGames),
+				    baseSeed + (unsigned int)((match-1) * totalGames + first), moveBudget };
+		jobs.push_back(formatShard(shard));
+		jobMatch.push_back(match);
+	    }
+	}
+    }
+
+    cout << "Playing " << match << " matches in " << jobs.size() << " shards across "
+	 << workers << " worker processes (no visual display)." << endl;
+    if( results.isOpen() ) {
+	cerr << "Warning: shards only report totals, so the results file gets match and standings"
+	     << " records but no per-game records." << endl;
+    }
+    vector<string> output;
+    results.pause();	// No writer thread across the fork
+    bool ok = runInWorkers(workers, jobs, runShardJob, output);
+    results.resume();
+
+    size_t job = 0;
+    for( int player1Id=0; player1Id<NumPlayers; player1Id++ ) {
+	for( int player2Id=player1Id+1; player2Id<NumPlayers; player2Id++ ) {
+	    int matchWins[2] = {0, 0};
+	    int ties = 0;
+	    matchNumber++;
+	    for( ; job<jobs.size() && jobMatch[job]==matchNumber; job++ ) {
+		ShardResult result;
+		if( !parseShardResult(output[job], result) ) {
+		    ok = false;
+		    continue;
+		}
+		matchWins[0] += result.player1Wins;
+		matchWins[1] += result.player2Wins;
+		ties += result.ties;
+		statsShotsTaken[player1Id] += result.player1Shots;
+		statsGamesCounted[player1Id] += result.player1Games;
+		statsShotsTaken[player2Id] += result.player2Shots;
+		statsGamesCounted[player2Id] += result.player2Games;
+	    }
+	    wins[player1Id][player2Id] += matchWins[0];
+	    wins[player2Id][player1Id] += matchWins[1];
+	    reportMatch( player1Id, player2Id, matchWins, ties, ties );
+	}
+    }
+    if( !ok ) {
+	cerr << "Warning: some shards failed; their games are missing from the results." << endl;
+    }
+}
+
+/*
+ * Plays one shard silently with freshly constructed players, wrapped in
+ * TimedPlayers as playMatch() does so they get the same move budget and
+ * batched updates.
+ */
+ShardResult playShard( const GameShard& shard ) {
+    ShardResult result = { shard.match, shard.player1Id, shard.player2Id, 0, 0, 0, 0, 0, 0, 0 };
+    PlayerV2* player1 = getPlayer(shard.player1Id, shard.boardSize);
+    PlayerV2* player2 = getPlayer(shard.player2Id, shard.boardSize);
+    introduce( player1, playerNames[shard.player2Id] );
+    introduce( player2, playerNames[shard.player1Id] );
+    // Deleted before the players: they hand over any updates still queued
+    TimedPlayer* timed1 = new TimedPlayer(player1, shard.boardSize);
+    TimedPlayer* timed2 = new TimedPlayer(player2, shard.boardSize);
+    timed1->setMoveBudget(shard.moveBudget);
+    timed2->setMoveBudget(shard.moveBudget);
+
+    for( int count=shard.firstGame; count<shard.endGame; count++ ) {
+	bool player1Won = false, player2Won = false;
+	int moves = 0;
+	srand(shard.seed + (unsigned int)(count - shard.firstGame));
+	timed1->newRound();
+	timed2->newRound();
+	AIContest game( timed1, playerNames[shard.player1Id], timed2, playerNames[shard.player2Id],
+			shard.boardSize, true );
+	game.play( 0, moves, player1Won, player2Won );
+
+	if((player1Won && player2Won) || !(player1Won || player2Won)) {
+	    result.ties++;
+	    result.player1Shots += moves;
+	    result.player1Games++;
+	    result.player2Shots += moves;
+	    result.player2Games++;
+	} else if( player1Won ) {
+	    result.player1Wins++;
+	    result.player1Shots += moves;
+	    result.player1Games++;
+	} else {
+	    result.player2Wins++;
+	    result.player2Shots += moves;
+	    result.player2Games++;
+	}
+    }
+    delete timed1;
+    delete timed2;
+    delete player1;
+    delete player2;
+    return result;
+}
+
+/*
+ * Worker entry point for runInWorkers(): one shard line in, one result line out.
+ */
+string runShardJob( const string& line ) {
+    GameShard shard;
+    if( !parseShard(line, shard) || shard.player1Id < 0 || shard.player1Id >= NumPlayers
+	|| shard.player2Id < 0 || shard.player2Id >= NumPlayers
+	|| shard.boardSize < 3 || shard.boardSize > MAX_BOARD_SIZE || shard.moveBudget < 0 ) {
+	return "error " + line;
+    }
+    return formatShardResult(playShard(shard));
+}
+
+/*
+ * --shard-file: plays the shards listed in a file (as written by formatShard)
+ * and prints one result line per shard, in order. Uses --workers processes.
+ */
+int runShardFile( const string& path ) {
+    ifstream in(path.c_str());
+    if( !in ) {
+	cerr << "Could not open " << path << endl;
+	return 1;
+    }
+    vector<string> jobs, output;
+    string line;
+    while( getline(in, line) ) {
+	if( !line.empty() ) jobs.push_back(line);
+    }
+    bool ok = runInWorkers(workers, jobs, runShardJob, output);
+    for( size_t i=0; i<output.size(); i++ ) {
+	cout << output[i] << endl;
+	if( output[i].compare(0, 7, "result ") != 0 ) ok = false;
+    }
+    return ok ? 0 : 1;
+}
+
+/*
+ * Players are created once per contest and reused for every match they play,
+ * so their constructors run once and anything they learn carries over.
+ */
+PlayerV2* getPooledPlayer( int playerId ) {
+    if( playerPool[playerId] == NULL ) {
+	playerPool[playerId] = getPlayer(playerId, boardSize);
+    }
+    return playerPool[playerId];
+}
+
+void releasePlayerPool() {
+    for( int i=0; i<NumPlayers; i++ ) {
+	delete playerPool[i];
+	playerPool[i] = NULL;
+    }
+}
+
+/*
+ * Tells a player who its next opponent is, if it wants to know.
+ */
+void introduce( PlayerV2* player, const string& opponentName ) {
+    OpponentAware* aware = dynamic_cast<OpponentAware*>(player);
+    if( aware != NULL ) {
+	aware->setOpponent(opponentName);
+    }
+}
+
 PlayerV2* getPlayer( int playerId, int boardSize ) {
     switch( playerId ) {
 	default:       // use 'default' to avoid compiler warning
@@ -0,0 +1,452 @@
+/**
+ * @brief Parameter sweeps for Yu/Bell Player's tuning constants.
+ * @file tune.cpp
+ *
+ * Each candidate set of YuBellParams plays the same seeded games against each
+ * tuning opponent, so candidates are compared on identical deals. The
+ * (candidate, opponent) matches run in forked worker processes, one whole
+ * match per job so the player keeps learning across its rounds as it would in
+ * a contest. The default constants are always candidate 0.
+ *
+ * Searches:
+ *   grid    every combination of --steps evenly spaced values of the --vary
+ *           parameters, the others left at their defaults
+ *   random  --candidates points drawn uniformly from the whole range
+ *   es      --generations rounds of --candidates points drawn around the mean
+ *           of the previous round's best half, with per-parameter spread taken
+ *           from that half (a diagonal, cross-entropy flavour of CMA-ES)
+ *
+ * Candidates are ranked by win rate, then by shots per game; both are shown
+ * with 95% confidence intervals (normal approximation).
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "AIContest.h"
+#include "PlayerV2.h"
+#include "PlayerExtensions.h"
+#include "ShardRunner.h"
+#include "TimedPlayer.h"
+#include "YuBellPlayer.h"
+#include "DumbPlayerV2.h"
+#include "OrigGamblerPlayerV2.h"
+#include "LearningGambler2.h"
+
+using namespace std;
+
+/*
+ * The tunable constants, in the order they appear in a candidate's values.
+ */
+struct TunableParam {
+    const char* name;
+    double low;
+    double high;
+    bool integral;
+};
+
+const TunableParam TunableParams[] = {
+    { "attackWeight",      1,    8, true },
+    { "placementWeight",   1,    8, true },
+    { "adjacencyPenalty",  0, 2000, true },
+    { "topPlacements",     1,   10, true },
+    { "topPlacementBoost", 0,    2, false },
+    { "cornerValue",       1,    6, true },
+    { "edgeValue",         1,    6, true },
+    { "ringStep",          0,    3, true },
+    { "arrivalWeight",     0,    4, false },
+};
+const int NumTunableParams = sizeof(TunableParams) / sizeof(TunableParams[0]);
+
+const char* OpponentNames[] = { "Dumb Player", "Orig Gambler", "Learning Gambler", "Yu/Bell Player" };
+const int NumOpponents = sizeof(OpponentNames) / sizeof(OpponentNames[0]);
+
+// Results of one candidate, summed over its games
+struct Tally {
+    long games;
+    long wins;
+    double shots;
+    double shotsSquared;
+};
+
+typedef vector<double> Candidate;
+
+int boardSize = 10;
+int gamesPerOpponent = 200;
+unsigned int seed = 20170410;
+
+YuBellParams toParams( const Candidate& values );
+Candidate fromParams( const YuBellParams& params );
+Candidate clamped( Candidate values );
+string formatCandidate( const Candidate& values );
+string runMatchJob( const string& line );
+bool evaluate( int workers, const vector<Candidate>& candidates, vector<Tally>& tallies );
+bool betterThan( const Tally& a, const Tally& b );
+void report( const vector<Candidate>& candidates, const vector<Tally>& tallies );
+double uniform();
+double gaussian();
+
+YuBellParams toParams( const Candidate& values ) {
+    YuBellParams params;
+    params.attackWeight = (int)values[0];
+    params.placementWeight = (int)values[1];
+    params.adjacencyPenalty = (int)values[2];
+    params.topPlacements = (int)values[3];
+    params.topPlacementBoost = values[4];
+    params.cornerValue = (int)values[5];
+    params.edgeValue = (int)values[6];
+    params.ringStep = (int)values[7];
+    params.arrivalWeight = values[8];
+    return params;
+}
+
+Candidate fromParams( const YuBellParams& params ) {
+    Candidate values(NumTunableParams);
+    values[0] = params.attackWeight;
+    values[1] = params.placementWeight;
+    values[2] = params.adjacencyPenalty;
+    values[3] = params.topPlacements;
+    values[4] = params.topPlacementBoost;
+    values[5] = params.cornerValue;
+    values[6] = params.edgeValue;
+    values[7] = params.ringStep;
+    values[8] = params.arrivalWeight;
+    return values;
+}
+
+/*
+ * Pulls values back into range and rounds the integral ones.
+ */
+Candidate clamped( Candidate values ) {
+    for( int i=0; i<NumTunableParams; i++ ) {
+	values[i] = max(TunableParams[i].low, min(TunableParams[i].high, values[i]));
+	if( TunableParams[i].integral ) {
+	    values[i] = floor(values[i] + 0.5);
+	}
+    }
+    return values;
+}
+
+string formatCandidate( const Candidate& values ) {
+    ostringstream text;
+    for( int i=0; i<NumTunableParams; i++ ) {
+	text << (i > 0 ? " " : "") << TunableParams[i].name << "=" << values[i];
+    }
+    return text.str();
+}
+
+/*
+ * Worker side. Job line:    <candidate> <opponent> <value>...
+ * Result line: <candidate> <games> <wins> <shots> <shotsSquared>
+ */
+string runMatchJob( const string& line ) {
+    istringstream in(line);
+    int candidateIndex, opponentId;
+    Candidate values(NumTunableParams);
+    in >> candidateIndex >> opponentId;
+    for( int i=0; i<NumTunableParams; i++ ) {
+	in >> values[i];
+    }
+    if( !in || opponentId < 0 || opponentId >= NumOpponents ) {
+	return "error " + line;
+    }
+
+    YuBellPlayer* yuBell = new YuBellPlayer( boardSize );
+    yuBell->setParams(toParams(values));
+    PlayerV2* opponent;
+    switch( opponentId ) {
+	default:
+	case 0: opponent = new DumbPlayerV2( boardSize ); break;
+	case 1: opponent = new OrigGamblerPlayerV2( boardSize ); break;
+	case 2: opponent = new LearningGambler2( boardSize ); break;
+	case 3: opponent = new YuBellPlayer( boardSize ); break;
+    }
+    yuBell->setOpponent(OpponentNames[opponentId]);
+    OpponentAware* aware = dynamic_cast<OpponentAware*>(opponent);
+    if( aware != NULL ) {
+	aware->setOpponent("Yu/Bell Player (tuning)");
+    }
+    // Wrapped as in a contest, so updates arrive batched
+    TimedPlayer* timedYuBell = new TimedPlayer(yuBell, boardSize);
+    TimedPlayer* timedOpponent = new TimedPlayer(opponent, boardSize);
+
+    // Every candidate plays the same deals against a given opponent
+    Tally tally = { 0, 0, 0, 0 };
+    for( int game=0; game<gamesPerOpponent; game++ ) {
+	bool yuBellWon = false, opponentWon = false;
+	int moves = 0;
+	srand(seed + opponentId * gamesPerOpponent + game);
+	timedYuBell->newRound();
+	timedOpponent->newRound();
+	AIContest contest( timedYuBell, "Yu/Bell Player (tuning)", timedOpponent, OpponentNames[opponentId],
+			   boardSize, true );
+	contest.play( 0, moves, yuBellWon, opponentWon );
+	tally.games++;
+	if( yuBellWon && !opponentWon ) tally.wins++;
+	tally.shots += moves;
+	tally.shotsSquared += (double)moves * moves;
+    }
+    delete timedYuBell;
+    delete timedOpponent;
+    delete yuBell;
+    delete opponent;
+
+    ostringstream result;
+    result << candidateIndex << " " << tally.games << " " << tally.wins << " "
+	   << tally.shots << " " << tally.shotsSquared;
+    return result.str();
+}
+
+/*
+ * Plays every candidate against every opponent and sums the results per candidate.
+ */
+bool evaluate( int workers, const vector<Candidate>& candidates, vector<Tally>& tallies ) {
+    vector<string> jobs, output;
+    for( size_t c=0; c<candidates.size(); c++ ) {
+	for( int opponentId=0; opponentId<NumOpponents; opponentId++ ) {
+	    ostringstream job;
+	    job.precision(17);
+	    job << c << " " << opponentId;
+	    for( int i=0; i<NumTunableParams; i++ ) {
+		job << " " << candidates[c][i];
+	    }
+	    jobs.push_back(job.str());
+	}
+    }
+    if( !runInWorkers(workers, jobs, runMatchJob, output) ) {
+	return false;
+    }
+
+    Tally empty = { 0, 0, 0, 0 };
+    tallies.assign(candidates.size(), empty);
+    for( size_t j=0; j<output.size(); j++ ) {
+	istringstream in(output[j]);
+	size_t c;
+	Tally part;
+	if( !(in >> c >> part.games >> part.wins >> part.shots >> part.shotsSquared)
+	    || c >= candidates.size() ) {
+	    cerr << "Bad result from worker: " << output[j] << endl;
+	    return false;
+	}
+	tallies[c].games += part.games;
+	tallies[c].wins += part.wins;
+	tallies[c].shots += part.shots;
+	tallies[c].shotsSquared += part.shotsSquared;
+    }
+    return true;
+}
+
+double winRate( const Tally& tally ) {
+    return tally.games > 0 ? (double)tally.wins / tally.games : 0;
+}
+
+double winRateMargin( const Tally& tally ) {
+    double p = winRate(tally);
+    return tally.games > 0 ? 1.96 * sqrt(p * (1 - p) / tally.games) : 0;
+}
+
+double meanShots( const Tally& tally ) {
+    return tally.games > 0 ? tally.shots / tally.games : 0;
+}
+
+double meanShotsMargin( const Tally& tally ) {
+    if( tally.games < 2 ) {
+	return 0;
+    }
+    double variance = (tally.shotsSquared - tally.shots * tally.shots / tally.games) / (tally.games - 1);
+    return 1.96 * sqrt(max(0.0, variance) / tally.games);
+}
+
+bool betterThan( const Tally& a, const Tally& b ) {
+    if( a.wins * b.games != b.wins * a.games ) {
+	return a.wins * b.games > b.wins * a.games;
+    }
+    return meanShots(a) < meanShots(b);
+}
+
+/*
+ * Prints the candidates, best first.
+ */
+void report( const vector<Candidate>& candidates, const vector<Tally>& tallies ) {
+    vector<size_t> order;
+    for( size_t c=0; c<candidates.size(); c++ ) {
+	order.push_back(c);
+    }
+    stable_sort(order.begin(), order.end(), [&tallies]( size_t a, size_t b ) {
+	return betterThan(tallies[a], tallies[b]);
+    });
+
+    cout << fixed << setprecision(2);
+    for( size_t rank=0; rank<order.size(); rank++ ) {
+	const Tally& tally = tallies[order[rank]];
+	cout << setw(3) << rank+1 << ". win " << setw(6) << 100 * winRate(tally) << "% +/- "
+	     << setw(5) << 100 * winRateMargin(tally) << "  shots/game " << setw(6) << meanShots(tally)
+	     << " +/- " << setw(5) << meanShotsMargin(tally) << "  "
+	     << formatCandidate(candidates[order[rank]])
+	     << (order[rank] == 0 ? "  (defaults)" : "") << endl;
+    }
+    cout.unsetf(ios::floatfield);
+}
+
+double uniform() {
+    return (rand() + 0.5) / ((double)RAND_MAX + 1);
+}
+
+// Box-Muller
+double gaussian() {
+    return sqrt(-2 * log(uniform())) * cos(2 * M_PI * uniform());
+}
+
+/*
+ * Options:
+ *   --search=grid|random|es  (default random)
+ *   --board=N                board size (default 10)
+ *   --games=N                games per candidate per opponent (default 200)
+ *   --candidates=N           random: points to try; es: points per generation (default 16)
+ *   --generations=N          es only (default 5)
+ *   --vary=NAME,NAME         grid only: parameters to vary (default attackWeight,placementWeight)
+ *   --steps=N                grid only: values per varied parameter (default 4)
+ *   --workers=N              worker processes (default: one per core)
+ *   --seed=N                 seeds the deals and the search (default 20170410)
+ */
+int main( int argc, char* argv[] ) {
+    string search = "random", vary = "attackWeight,placementWeight";
+    int candidateCount = 16, generations = 5, steps = 4;
+    int workers = max(1L, sysconf(_SC_NPROCESSORS_ONLN));
+    for( int i=1; i<argc; i++ ) {
+	if( strncmp(argv[i], "--search=", 9) == 0 ) {
+	    search = argv[i] + 9;
+	} else if( strncmp(argv[i], "--board=", 8) == 0 ) {
+	    boardSize = atoi(argv[i] + 8);
+	} else if( strncmp(argv[i], "--games=", 8) == 0 ) {
+	    gamesPerOpponent = atoi(argv[i] + 8);
+	} else if( strncmp(argv[i], "--candidates=", 13) == 0 ) {
+	    candidateCount = atoi(argv[i] + 13);
+	} else if( strncmp(argv[i], "--generations=", 14) == 0 ) {
+	    generations = atoi(argv[i] + 14);
+	} else if( strncmp(argv[i], "--vary=", 7) == 0 ) {
+	    vary = argv[i] + 7;
+	} else if( strncmp(argv[i], "--steps=", 8) == 0 ) {
+	    steps = atoi(argv[i] + 8);
+	} else if( strncmp(argv[i], "--workers=", 10) == 0 ) {
+	    workers = atoi(argv[i] + 10);
+	} else if( strncmp(argv[i], "--seed=", 7) == 0 ) {
+	    seed = strtoul(argv[i] + 7, NULL, 10);
+	} else {
+	    cerr << "Unknown option: " << argv[i] << endl;
+	    return 1;
+	}
+    }
+    if( boardSize < 3 || boardSize > MAX_BOARD_SIZE || gamesPerOpponent < 1 || candidateCount < 1
+	|| generations < 1 || steps < 1 || workers < 1 ) {
+	cerr << "Option out of range." << endl;
+	return 1;
+    }
+    srand(seed);
+
+    Candidate defaults = fromParams(YuBellParams());
+    vector<Candidate> candidates(1, defaults);
+    vector<Tally> tallies;
+
+    if( search == "grid" ) {
+	vector<int> varied;
+	stringstream names(vary);
+	string name;
+	while( getline(names, name, ',') ) {
+	    int found = -1;
+	    for( int i=0; i<NumTunableParams; i++ ) {
+		if( name == TunableParams[i].name ) found = i;
+	    }
+	    if( found < 0 ) {
+		cerr << "Unknown parameter: " << name << endl;
+		return 1;
+	    }
+	    varied.push_back(found);
+	}
+	// Count through the grid like an odometer
+	vector<int> step(varied.size(), 0);
+	do {
+	    Candidate values = defaults;
+	    for( size_t v=0; v<varied.size(); v++ ) {
+		const TunableParam& param = TunableParams[varied[v]];
+		values[varied[v]] = steps == 1 ? param.low
+		    : param.low + (param.high - param.low) * step[v] / (steps - 1);
+	    }
+	    candidates.push_back(clamped(values));
+	    size_t v = 0;
+	    while( v < step.size() && ++step[v] == steps ) {
+		step[v++] = 0;
+	    }
+	    if( v == step.size() ) break;
+	} while( true );
+    } else if( search == "random" || search == "es" ) {
+	for( int c=0; c<candidateCount; c++ ) {
+	    Candidate values(NumTunableParams);
+	    for( int i=0; i<NumTunableParams; i++ ) {
+		values[i] = TunableParams[i].low + (TunableParams[i].high - TunableParams[i].low) * uniform();
+	    }
+	    candidates.push_back(clamped(values));
+	}
+    } else {
+	cerr << "Unknown search: " << search << endl;
+	return 1;
+    }
+
+    cout << candidates.size() << " candidates x " << NumOpponents << " opponents x "
+	 << gamesPerOpponent << " games on a " << boardSize << "x" << boardSize
+	 << " board, " << workers << " workers" << endl;
+    if( !evaluate(workers, candidates, tallies) ) {
+	return 1;
+    }
+
+    for( int generation=1; search == "es" && generation<generations; generation++ ) {
+	// Refit the sampling distribution to the better half of everything seen so far
+	vector<size_t> order;
+	for( size_t c=0; c<candidates.size(); c++ ) order.push_back(c);
+	stable_sort(order.begin(), order.end(), [&tallies]( size_t a, size_t b ) {
+	    return betterThan(tallies[a], tallies[b]);
+	});
+	size_t elite = max((size_t)2, order.size() / 2);
+	Candidate mean(NumTunableParams, 0), spread(NumTunableParams, 0);
+	for( size_t e=0; e<elite; e++ ) {
+	    for( int i=0; i<NumTunableParams; i++ ) mean[i] += candidates[order[e]][i] / elite;
+	}
+	for( size_t e=0; e<elite; e++ ) {
+	    for( int i=0; i<NumTunableParams; i++ ) {
+		double d = candidates[order[e]][i] - mean[i];
+		spread[i] += d * d / elite;
+	    }
+	}
+
+	cout << "Generation " << generation << ": best so far win "
+	     << 100 * winRate(tallies[order[0]]) << "%, " << meanShots(tallies[order[0]])
+	     << " shots/game" << endl;
+	vector<Candidate> next;
+	for( int c=0; c<candidateCount; c++ ) {
+	    Candidate values(NumTunableParams);
+	    for( int i=0; i<NumTunableParams; i++ ) {
+		// Keep some spread so integral parameters don't freeze too early
+		double sigma = max(sqrt(spread[i]), 0.05 * (TunableParams[i].high - TunableParams[i].low));
+		values[i] = mean[i] + sigma * gaussian();
+	    }
+	    next.push_back(clamped(values));
+	}
+	vector<Tally> nextTallies;
+	if( !evaluate(workers, next, nextTallies) ) {
+	    return 1;
+	}
+	candidates.insert(candidates.end(), next.begin(), next.end());
+	tallies.insert(tallies.end(), nextTallies.begin(), nextTallies.end());
+    }
+
+    report(candidates, tallies);
+    return 0;
+}